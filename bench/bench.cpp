@@ -0,0 +1,316 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+// Measures the per call overhead of the wrapper against the raw GLFW C calls it wraps. Everything runs on the null
+//  platform so results are comparable between machines with and without a display. Results are written to stdout as
+//  a single JSON document, pass a substring as the first argument to only run the matching benchmarks.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+import glfw;
+
+namespace
+{
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations;
+        double nsPerOp;
+        bool skipped;
+    };
+
+    std::vector<Result> results;
+    const char* filter = nullptr;
+    volatile uint64_t sink = 0; // Keeps the measured calls from being optimized out
+
+    bool selected(const std::string& name)
+    {
+        return filter == nullptr || name.find(filter) != std::string::npos;
+    }
+
+    template<typename Fun>
+    void run(const std::string& name, uint64_t iterations, Fun&& fun)
+    {
+        if(!selected(name))
+        {
+            return;
+        }
+
+        // Warm up caches and any lazily allocated state before timing
+        for(uint64_t i = 0; i < iterations / 10 + 1; ++i)
+        {
+            fun();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for(uint64_t i = 0; i < iterations; ++i)
+        {
+            fun();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+        results.push_back({name, iterations, ns / static_cast<double>(iterations), false});
+    }
+
+    void skip(const std::string& name)
+    {
+        if(selected(name))
+        {
+            results.push_back({name, 0, 0.0, true});
+        }
+    }
+
+    void print()
+    {
+        std::printf("{\n  \"platform\": \"null\",\n  \"benchmarks\": [");
+        for(std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+            std::printf("%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"skipped\": %s}",
+                    i == 0 ? "" : ",", result.name.c_str(), static_cast<unsigned long long>(result.iterations),
+                    result.nsPerOp, result.skipped ? "true" : "false");
+        }
+        std::printf("\n  ]\n}\n");
+    }
+
+    // Raw callbacks doing the same work as the wrapper callbacks so only the dispatch path differs
+    void rawKey(GLFWwindow*, int key, int, int, int) { sink = sink + key; }
+    void rawChar(GLFWwindow*, unsigned int codepoint) { sink = sink + codepoint; }
+    void rawMouseButton(GLFWwindow*, int button, int, int) { sink = sink + button; }
+    void rawCursorPos(GLFWwindow*, double x, double) { sink = sink + static_cast<uint64_t>(x); }
+    void rawScroll(GLFWwindow*, double, double y) { sink = sink + static_cast<uint64_t>(y); }
+    void rawSize(GLFWwindow*, int width, int) { sink = sink + width; }
+    void rawFramebufferSize(GLFWwindow*, int width, int) { sink = sink + width; }
+    void rawFocus(GLFWwindow*, int focused) { sink = sink + focused; }
+
+    // GLFW has no getter for callbacks, but setting one returns the previous so swap it out and straight back
+    template<typename Fun>
+    Fun installedCallback(GLFWwindow* window, Fun (*set)(GLFWwindow*, Fun))
+    {
+        auto fun = set(window, nullptr);
+        set(window, fun);
+        return fun;
+    }
+
+    // Calls the installed wrapper trampoline and then the raw callback directly, the way GLFW itself would
+    template<typename Fun, typename... Args>
+    void dispatch(const char* event, glfw::Window& window, Fun (*set)(GLFWwindow*, Fun), Fun raw, Args... args)
+    {
+        constexpr uint64_t iterations = 2'000'000;
+
+        auto trampoline = installedCallback(window.get(), set);
+        run(std::string("dispatch/") + event + "/glfw_cpp", iterations, [&]{ trampoline(window.get(), args...); });
+
+        // Called through a volatile pointer so the raw callback is not inlined where the trampoline can not be
+        Fun volatile direct = raw;
+        run(std::string("dispatch/") + event + "/glfw", iterations, [&]{ direct(window.get(), args...); });
+    }
+
+    void benchDispatch(glfw::Window& window)
+    {
+        window.setKeyCallback([](glfw::Window&, glfw::Key key, int, glfw::KeyAction, int)
+        {
+            sink = sink + static_cast<int>(key);
+        });
+        window.setCharCallback([](glfw::Window&, unsigned int codepoint) { sink = sink + codepoint; });
+        window.setMouseButtonCallback([](glfw::Window&, glfw::MouseButton button, glfw::KeyAction, int)
+        {
+            sink = sink + static_cast<int>(button);
+        });
+        window.setCursorPosCallback([](glfw::Window&, glfw::Position<double> pos)
+        {
+            sink = sink + static_cast<uint64_t>(pos.x);
+        });
+        window.setScrollCallback([](glfw::Window&, glfw::Position<double> offset)
+        {
+            sink = sink + static_cast<uint64_t>(offset.y);
+        });
+        window.setSizeCallback([](glfw::Window&, glfw::Size size) { sink = sink + size.width; });
+        window.setFramebufferSizeCallback([](glfw::Window&, glfw::Size size) { sink = sink + size.width; });
+        window.setFocusCallback([](glfw::Window&, bool focused) { sink = sink + focused; });
+
+        dispatch("key", window, glfwSetKeyCallback, GLFWkeyfun(rawKey), GLFW_KEY_A, 30, GLFW_PRESS, 0);
+        dispatch("char", window, glfwSetCharCallback, GLFWcharfun(rawChar), 0x61u);
+        dispatch("mouse_button", window, glfwSetMouseButtonCallback, GLFWmousebuttonfun(rawMouseButton),
+                GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, 0);
+        dispatch("cursor_pos", window, glfwSetCursorPosCallback, GLFWcursorposfun(rawCursorPos), 12.0, 34.0);
+        dispatch("scroll", window, glfwSetScrollCallback, GLFWscrollfun(rawScroll), 0.0, 1.0);
+        dispatch("window_size", window, glfwSetWindowSizeCallback, GLFWwindowsizefun(rawSize), 640, 480);
+        dispatch("framebuffer_size", window, glfwSetFramebufferSizeCallback,
+                GLFWframebuffersizefun(rawFramebufferSize), 640, 480);
+        dispatch("focus", window, glfwSetWindowFocusCallback, GLFWwindowfocusfun(rawFocus), GLFW_TRUE);
+    }
+
+    void benchGetters(glfw::Window& window)
+    {
+        constexpr uint64_t iterations = 2'000'000;
+        auto handle = window.get();
+
+        run("window/get_size/glfw_cpp", iterations, [&]{ sink = sink + window.getSize().width; });
+        run("window/get_size/glfw", iterations, [&]
+        {
+            int width, height;
+            glfwGetWindowSize(handle, &width, &height);
+            sink = sink + width;
+        });
+
+        run("window/get_framebuffer_size/glfw_cpp", iterations, [&]{ sink = sink + window.getFramebufferSize().width; });
+        run("window/get_framebuffer_size/glfw", iterations, [&]
+        {
+            int width, height;
+            glfwGetFramebufferSize(handle, &width, &height);
+            sink = sink + width;
+        });
+
+        run("window/get_cursor_pos/glfw_cpp", iterations, [&]
+        {
+            sink = sink + static_cast<uint64_t>(window.getCursorPos().x);
+        });
+        run("window/get_cursor_pos/glfw", iterations, [&]
+        {
+            double x, y;
+            glfwGetCursorPos(handle, &x, &y);
+            sink = sink + static_cast<uint64_t>(x);
+        });
+    }
+
+    void benchMonitors()
+    {
+        constexpr uint64_t iterations = 500'000;
+
+        run("monitor/get_monitors/glfw_cpp", iterations, [&]{ sink = sink + glfw::getMonitors().size(); });
+        run("monitor/get_monitors/glfw", iterations, [&]
+        {
+            int count;
+            glfwGetMonitors(&count);
+            sink = sink + count;
+        });
+
+        auto monitor = glfw::getPrimaryMonitor();
+        if(monitor.get() == nullptr)
+        {
+            skip("monitor/get_video_modes/glfw_cpp");
+            skip("monitor/get_video_modes/glfw");
+            return;
+        }
+
+        run("monitor/get_video_modes/glfw_cpp", iterations, [&]{ sink = sink + monitor.getVideoModes().size(); });
+        run("monitor/get_video_modes/glfw", iterations, [&]
+        {
+            int count;
+            glfwGetVideoModes(monitor.get(), &count);
+            sink = sink + count;
+        });
+    }
+
+    void benchJoystick()
+    {
+        constexpr uint64_t iterations = 2'000'000;
+
+        // The null platform has no joysticks, this only measures something when run with a gamepad on another platform
+        glfw::Joystick gamepad(GLFW_JOYSTICK_1);
+        for(int jid = GLFW_JOYSTICK_1; jid <= GLFW_JOYSTICK_LAST; ++jid)
+        {
+            if(glfwJoystickIsGamepad(jid))
+            {
+                gamepad = glfw::Joystick(jid);
+                break;
+            }
+        }
+
+        if(!gamepad.isGamepad())
+        {
+            skip("joystick/get_gamepad_state/glfw_cpp");
+            skip("joystick/get_gamepad_state/glfw");
+            return;
+        }
+
+        run("joystick/get_gamepad_state/glfw_cpp", iterations, [&]
+        {
+            sink = sink + gamepad.getGamepadState().buttons[0];
+        });
+        run("joystick/get_gamepad_state/glfw", iterations, [&]
+        {
+            GLFWgamepadstate state;
+            glfwGetGamepadState(gamepad.get(), &state);
+            sink = sink + state.buttons[0];
+        });
+    }
+
+    void benchConstruction()
+    {
+        run("cursor/construct/glfw_cpp", 100'000, [&]
+        {
+            glfw::Cursor cursor(glfw::CursorShape::ARROW_CURSOR);
+            sink = sink + static_cast<bool>(cursor);
+        });
+        run("cursor/construct/glfw", 100'000, [&]
+        {
+            auto cursor = glfwCreateStandardCursor(GLFW_ARROW_CURSOR);
+            sink = sink + (cursor != nullptr);
+            glfwDestroyCursor(cursor);
+        });
+
+        run("window/construct/glfw_cpp", 10'000, [&]
+        {
+            glfw::Window window(64, 64, "bench");
+            sink = sink + static_cast<bool>(window);
+        });
+        run("window/construct/glfw", 10'000, [&]
+        {
+            auto window = glfwCreateWindow(64, 64, "bench", nullptr, nullptr);
+            sink = sink + (window != nullptr);
+            glfwDestroyWindow(window);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc > 1)
+    {
+        filter = argv[1];
+    }
+
+    glfw::Library library(glfw::LibraryOptions{.headless = true});
+
+    // No context is needed for any of this, leaving it out keeps window creation free of OSMesa
+    glfw::windowHint(glfw::WindowHint::VISIBLE, false);
+    glfw::windowHint(glfw::WindowHint::CLIENT_API, glfw::WindowValue::NO_API);
+
+    glfw::Window window(640, 480, "glfw_cpp_bench");
+
+    benchDispatch(window);
+    benchGetters(window);
+    benchMonitors();
+    benchJoystick();
+    benchConstruction();
+
+    print();
+    return 0;
+}
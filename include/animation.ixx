@@ -0,0 +1,95 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <span>
+#include <thread>
+#include <vector>
+
+export module glfw:animation;
+
+import :type;
+import :image;
+import :cursor;
+import :window;
+
+export namespace glfw
+{
+    using CursorFrameDecoder = std::function<Image(std::size_t index)>;
+
+    // Plays a cursor animation from cursors built once up front, so advancing a frame is only a setCursor call.
+    //  Frames advance on the timer, call update once per frame such as after FrameScheduler::waitForNextFrame. The
+    //  animation holds its current frame while stopped, while the window is unfocused and while it is iconified.
+    class AnimatedCursor
+    {
+    public:
+        AnimatedCursor(Window& window, std::span<const ImageView> frames, Position<int> posHot, double frameDuration);
+
+        // Decodes the frames in order on a worker thread, the cursors are still created on the main thread by update
+        //  as frames come in. Playback starts once every frame is built.
+        AnimatedCursor(Window& window, std::size_t frameCount, CursorFrameDecoder decoder, Position<int> posHot,
+                       double frameDuration);
+        ~AnimatedCursor(); // Waits for the decode thread
+
+        // Disable copy and assignment, the decode thread refers back to the animation
+        AnimatedCursor(const AnimatedCursor&) = delete;
+        AnimatedCursor& operator=(const AnimatedCursor&) = delete;
+
+        void update(); // Rethrows anything the decoder threw, again on every call once it failed
+        void play();
+        void stop();
+
+        [[nodiscard]] bool isReady() const; // Every frame has a cursor
+        [[nodiscard]] bool hasFailed() const; // The decoder threw and update has reported it
+        [[nodiscard]] bool isPlaying() const; // Playing and not held by focus or iconify
+        [[nodiscard]] std::size_t getFrame() const;
+        [[nodiscard]] std::size_t getFrameCount() const;
+
+    private:
+        void decode(CursorFrameDecoder decoder);
+        void advance(uint64_t now);
+
+        Window window; // A copy, so the window stays alive for as long as the animation
+        Position<int> posHot;
+        uint64_t frameTicks;
+        std::size_t frameCount;
+
+        std::vector<Cursor> cursors;
+        std::vector<Image> decoded;
+        std::atomic<std::size_t> decodedCount = 0; // Published by the decode thread after writing each image
+        std::atomic<bool> cancel = false;
+        std::exception_ptr failure;
+        std::thread thread;
+
+        std::size_t frame = 0;
+        std::size_t shown = SIZE_MAX;
+        uint64_t start = 0; // Timer value playback started at, moved forward by the time spent held
+        uint64_t heldSince = 0;
+        bool playing = true;
+        bool held = true; // Starts held until the first update after every frame is built
+    };
+}
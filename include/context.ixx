@@ -0,0 +1,148 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+export module glfw:context;
+
+import :type;
+import :window;
+
+namespace glfw
+{
+    // Resolves proc names and extension queries once per context. A context is only ever current on one thread so
+    //  the cache itself needs no locking, only the registry mapping contexts to caches does.
+    class ProcCache
+    {
+    public:
+        [[nodiscard]] glProc getProcAddress(const char* procname);
+        [[nodiscard]] bool extensionSupported(const char* extension);
+
+    private:
+        template<typename T>
+        struct Slot
+        {
+            uint64_t hash = 0;
+            std::string name;
+            T value{};
+            bool used = false;
+        };
+
+        // Open addressing with linear probing, kept under half full so probes stay short
+        template<typename T>
+        struct Table
+        {
+            std::vector<Slot<T>> slots = std::vector<Slot<T>>(64);
+            std::size_t count = 0;
+
+            // Either the slot holding the name or the empty slot it belongs in
+            [[nodiscard]] Slot<T>& find(uint64_t hash, const char* name);
+        };
+
+        Table<glProc> procs;
+        Table<bool> extensions;
+    };
+
+    [[nodiscard]] ProcCache* getProcCache(); // Cache of the calling thread's current context, null without one
+    void releaseProcCache(GLFWwindow* window); // Called as the window is destroyed, before its address can be reused
+    void resetProcCaches(); // Called on terminate, every context is gone
+
+    // Seeds the cache of one context with the lookups already made in another created from the same hints
+    void copyProcCache(GLFWwindow* from, GLFWwindow* to);
+}
+
+export namespace glfw
+{
+    struct ContextPoolStats
+    {
+        std::size_t size;
+        std::size_t available;
+        double creationTime; // Seconds spent creating all of the pool's windows
+        uint64_t acquires;
+        uint64_t waits; // Acquires that found the pool empty and had to block
+        double waitTime; // Seconds spent blocked in acquire
+    };
+
+    // Hidden windows whose contexts share objects with a main window, created up front on the main thread and lent
+    //  to worker threads for uploads that run alongside rendering. The current window hints apply to the pool's
+    //  windows as well, apart from visibility, so set them to match the main window first.
+    class ContextPool
+    {
+    public:
+        // Makes the pooled context current on the acquiring thread and, when destroyed, makes whatever context was
+        //  current before acquiring current again. Must be destroyed on the thread that acquired it.
+        class Lease
+        {
+        public:
+            Lease(Lease&& other) noexcept;
+            ~Lease();
+
+            // Disable copy and assignment, a lease is the only owner of its context
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            Lease& operator=(Lease&&) = delete;
+
+            [[nodiscard]] Window& getWindow() const;
+
+        private:
+            friend class ContextPool;
+
+            Lease(ContextPool* pool, std::size_t index);
+
+            ContextPool* pool;
+            std::size_t index;
+            GLFWwindow* previous; // Current on the acquiring thread before the lease
+        };
+
+        ContextPool(Window& main, std::size_t size);
+        ~ContextPool(); // Every lease must have been released
+
+        // Disable copy and assignment, leases point back at the pool
+        ContextPool(const ContextPool&) = delete;
+        ContextPool& operator=(const ContextPool&) = delete;
+
+        [[nodiscard]] Lease acquire(); // Blocks until a context is free
+        [[nodiscard]] std::optional<Lease> tryAcquire();
+        [[nodiscard]] ContextPoolStats getStats() const;
+
+    private:
+        [[nodiscard]] std::size_t take(); // Called with the mutex held, the lease is made after letting go of it
+        void release(std::size_t index);
+
+        std::vector<Window> windows;
+        std::vector<std::size_t> free;
+        mutable std::mutex mutex;
+        std::condition_variable condition;
+        double creationTime = 0.0;
+        uint64_t acquires = 0;
+        uint64_t waits = 0;
+        uint64_t waitTicks = 0;
+    };
+}
@@ -0,0 +1,160 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+export module glfw:coroutine;
+
+namespace glfw
+{
+    // Queues a suspended coroutine to be resumed after the current pollEvents, waitEvents or waitEventsTimeout
+    void scheduleResume(std::coroutine_handle<> handle);
+    void installCoroutineScheduler();
+}
+
+export namespace glfw
+{
+    // Fire and forget coroutine, it starts running straight away and frees itself when it finishes. Frames come from
+    //  a per thread pool of size classes so thousands of short lived input tasks do not each hit the heap. An
+    //  exception escaping the coroutine terminates, like one escaping a std::thread.
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            Task get_return_object() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept;
+
+            static void* operator new(std::size_t size);
+            static void operator delete(void* frame, std::size_t size) noexcept;
+        };
+    };
+
+    template<typename T>
+    class AwaiterList;
+
+    // Suspends the awaiting coroutine until the event it was created for arrives, then resumes it from the scheduler
+    //  with the event's value. Lives in the awaiting coroutine's frame, waiting never allocates.
+    template<typename T>
+    class EventAwaiter
+    {
+    public:
+        explicit EventAwaiter(AwaiterList<T>& list) : list(&list) {}
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle = awaiting;
+            list->push(this);
+        }
+
+        T await_resume() const
+        {
+            return value;
+        }
+
+    private:
+        friend class AwaiterList<T>;
+
+        AwaiterList<T>* list;
+        std::coroutine_handle<> handle;
+        EventAwaiter* next = nullptr;
+        T value{};
+    };
+
+    // Intrusive list of the coroutines waiting on one event source. Coroutines still waiting when the list is
+    //  destroyed, such as when their window is destroyed, are destroyed with it.
+    template<typename T>
+    class AwaiterList
+    {
+    public:
+        AwaiterList() = default;
+        ~AwaiterList()
+        {
+            for(auto awaiter = head; awaiter != nullptr;)
+            {
+                auto next = awaiter->next;
+                awaiter->handle.destroy();
+                awaiter = next;
+            }
+        }
+
+        // Disable copy and assignment, awaiters point back at the list
+        AwaiterList(const AwaiterList&) = delete;
+        AwaiterList& operator=(const AwaiterList&) = delete;
+
+        [[nodiscard]] bool empty() const
+        {
+            return head == nullptr;
+        }
+
+        void push(EventAwaiter<T>* awaiter)
+        {
+            awaiter->next = nullptr;
+            (tail == nullptr ? head : tail->next) = awaiter;
+            tail = awaiter;
+        }
+
+        // Hands every waiting coroutine the value and queues it for resumption, new awaiters start a fresh list
+        void complete(const T& value)
+        {
+            auto awaiter = head;
+            head = tail = nullptr;
+            while(awaiter != nullptr)
+            {
+                auto next = awaiter->next;
+                awaiter->value = value;
+                scheduleResume(awaiter->handle);
+                awaiter = next;
+            }
+        }
+
+    private:
+        EventAwaiter<T>* head = nullptr;
+        EventAwaiter<T>* tail = nullptr;
+    };
+
+    // Resumes on the next pollEvents, waitEvents or waitEventsTimeout with the number of event loop iterations so far
+    [[nodiscard]] EventAwaiter<uint64_t> nextFrame();
+}
@@ -20,12 +20,17 @@
 
 module;
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <unordered_map>
 #include <GLFW\glfw3.h>
 
 export module glfw:cursor;
 
 import :type;
+import :image;
 
 namespace glfw
 {
@@ -43,13 +48,74 @@ export namespace glfw
         Cursor();
         explicit Cursor(CursorShape shape); // Type checked/convince overload
         explicit Cursor(int shape);
-        explicit Cursor(const Image& image, Position<int> posHot = {0, 0});
+        explicit Cursor(const ImageView& image, Position<int> posHot = {0, 0});
         explicit Cursor(GLFWcursor* cursor);
 
+        // Non-throwing variants of the constructors above
+        [[nodiscard]] static Result<Cursor> tryCreate(CursorShape shape); // Type checked/convince overload
+        [[nodiscard]] static Result<Cursor> tryCreate(int shape);
+        [[nodiscard]] static Result<Cursor> tryCreate(const ImageView& image, Position<int> posHot = {0, 0});
+
         operator GLFWcursor*() const; // NOLINT(*-explicit-constructor)
         operator bool() const; // NOLINT(*-explicit-constructor)
 
     private:
         std::unique_ptr<GLFWcursor, DeleterCursor> ptr;
     };
+
+    // Non-owning, valid for as long as the Cursor or CursorCache it came from
+    class CursorHandle
+    {
+    public:
+        CursorHandle() = default;
+        CursorHandle(const Cursor& cursor); // NOLINT(*-explicit-constructor)
+        explicit CursorHandle(GLFWcursor* cursor);
+
+        operator GLFWcursor*() const; // NOLINT(*-explicit-constructor)
+        explicit operator bool() const;
+
+    private:
+        GLFWcursor* cursor = nullptr;
+    };
+
+    struct ScaledCursorImage
+    {
+        ImageView image;
+        Position<int> posHot;
+        float scale; // Content scale the image was drawn for
+    };
+
+    // Creates each standard shape once on first use and custom cursors once per distinct image and hotspot, so
+    //  switching cursors on hover does no platform allocations after warm up. Like cursors themselves it must only be
+    //  used from the main thread.
+    class CursorCache
+    {
+    public:
+        CursorCache() = default;
+
+        // Disable copy and assignment, handed out handles point into the cache
+        CursorCache(const CursorCache&) = delete;
+        CursorCache& operator=(const CursorCache&) = delete;
+
+        [[nodiscard]] CursorHandle get(CursorShape shape);
+        [[nodiscard]] CursorHandle get(const ImageView& image, Position<int> posHot = {0, 0});
+
+        // Picks the smallest variant drawn for at least the given scale, usually Window::getContentScale, falling
+        //  back to the largest one
+        [[nodiscard]] CursorHandle get(std::span<const ScaledCursorImage> variants, Scale scale);
+
+        [[nodiscard]] std::size_t size() const; // Platform cursors currently created
+        void clear(); // Destroys every cursor, no handle may still be set on a window
+
+    private:
+        struct Entry
+        {
+            Image image;
+            Position<int> posHot;
+            Cursor cursor;
+        };
+
+        std::array<Cursor, GLFW_NOT_ALLOWED_CURSOR - GLFW_ARROW_CURSOR + 1> standard;
+        std::unordered_multimap<uint64_t, Entry> custom;
+    };
 }
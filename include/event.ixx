@@ -0,0 +1,136 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+module;
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <GLFW/glfw3.h>
+
+export module glfw:event;
+
+import :type;
+
+export namespace glfw
+{
+    enum class EventType : uint8_t
+    {
+        KEY,
+        CHAR,
+        MOUSE_BUTTON,
+        CURSOR_POS,
+        SCROLL,
+        WINDOW_SIZE,
+        FRAMEBUFFER_SIZE,
+        FOCUS,
+
+        // Never queued or recorded, only used to keep the window state current
+        ICONIFY,
+        WINDOW_POS,
+        CONTENT_SCALE,
+    };
+
+    struct KeyEvent
+    {
+        Key key;
+        int scancode;
+        KeyAction action;
+        int mods;
+    };
+
+    struct MouseButtonEvent
+    {
+        MouseButton button;
+        KeyAction action;
+        int mods;
+    };
+
+    // Compact POD record of a single window event, the payload is selected by type
+    struct Event
+    {
+        EventType type;
+        union
+        {
+            KeyEvent key;
+            unsigned int codepoint;
+            MouseButtonEvent mouseButton;
+            Position<double> cursorPos;
+            Position<double> scroll;
+            Size size;
+            bool focused;
+            bool iconified;
+            Position<int> pos;
+            Scale contentScale;
+        };
+    };
+
+    enum class CoalesceMode
+    {
+        NONE, // Every cursor pos and scroll event is delivered as it arrives
+        LAST_VALUE, // One cursor pos and scroll event per poll, carrying the newest position and offset
+        ACCUMULATE_DELTA, // One cursor pos and scroll event per poll, carrying the newest position and summed offset
+    };
+
+    // Aggregate delivered by the most recent coalescing flush
+    struct CoalescedInput
+    {
+        Position<double> cursorPos; // Newest cursor position
+        Position<double> cursorDelta; // Cursor motion summed over every folded event
+        Position<double> scroll; // Newest or summed scroll offset depending on the mode
+        uint32_t cursorEvents; // Raw cursor pos events behind this aggregate
+        uint32_t scrollEvents; // Raw scroll events behind this aggregate
+    };
+
+    struct CoalesceStats
+    {
+        uint64_t cursorEvents; // Raw cursor pos events received while coalescing
+        uint64_t cursorFolded; // Cursor pos events merged into another one instead of being delivered
+        uint64_t scrollEvents; // Raw scroll events received while coalescing
+        uint64_t scrollFolded; // Scroll events merged into another one instead of being delivered
+    };
+
+    // Fixed capacity single producer/single consumer ring of events. Nothing is allocated after construction, events
+    //  pushed while the ring is full are dropped and counted instead.
+    class EventQueue
+    {
+    public:
+        explicit EventQueue(std::size_t capacity = 1024); // Rounded up to a power of two
+
+        // Disable copy and assignment, the ring is shared between the producer and consumer by address
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        bool push(const Event& event);
+        [[nodiscard]] std::span<const Event> drain(); // Valid until the next call to drain
+        [[nodiscard]] std::size_t capacity() const;
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] uint64_t getDroppedCount() const;
+
+    private:
+        std::size_t mask;
+        std::unique_ptr<Event[]> ring;
+        std::unique_ptr<Event[]> drained;
+        alignas(64) std::atomic<std::size_t> head = 0; // Written by the producer only
+        alignas(64) std::atomic<std::size_t> tail = 0; // Written by the consumer only
+        std::atomic<uint64_t> dropped = 0;
+    };
+}
@@ -0,0 +1,134 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+export module glfw:executor;
+
+import :library;
+
+export namespace glfw
+{
+    // Runs tasks posted from any thread on the main thread. Posting is lock free and wakes a waitEvents call with an
+    //  empty event, only the first post after a drain posts one. Tasks are drained after every pollEvents, waitEvents
+    //  and waitEventsTimeout, at most the batch limit per call so a flood of tasks can not stall the event loop.
+    //  Construct and destroy it on the main thread while the library is initialized. Tasks may capture Window copies,
+    //  copying one touches no GLFW state, but the last copy of a window destroys it and must go on the main thread.
+    class MainThreadExecutor
+    {
+    public:
+        explicit MainThreadExecutor(std::size_t batchLimit = 64);
+        ~MainThreadExecutor(); // Tasks still queued are destroyed without running, their futures report broken_promise
+
+        // Disable copy and assignment, the event hook and producers refer to the executor by address
+        MainThreadExecutor(const MainThreadExecutor&) = delete;
+        MainThreadExecutor& operator=(const MainThreadExecutor&) = delete;
+
+        template<typename Fun>
+        void post(Fun&& fun); // Exceptions thrown by the task propagate out of the call that drained it
+
+        template<typename Fun>
+        [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<Fun>&>> submit(Fun&& fun);
+
+        template<typename Fun>
+        void dispatch(Fun&& fun); // Runs immediately when already on the main thread, posts otherwise
+
+        std::size_t drain(); // Runs up to the batch limit of queued tasks, returns how many ran
+        void setBatchLimit(std::size_t limit);
+        [[nodiscard]] std::size_t getBatchLimit() const;
+        [[nodiscard]] bool isMainThread() const;
+
+    private:
+        struct Task
+        {
+            virtual ~Task() = default;
+            virtual void run() = 0;
+
+            std::atomic<Task*> next = nullptr;
+        };
+
+        template<typename Fun>
+        struct FunctionTask final : Task
+        {
+            explicit FunctionTask(Fun&& fun) : fun(std::move(fun)) {}
+
+            void run() override
+            {
+                fun();
+            }
+
+            Fun fun;
+        };
+
+        void link(Task* task);
+        void push(Task* task); // Links the task and wakes the main thread when needed
+        Task* pop();
+
+        // Intrusive multiple producer/single consumer queue, producers only touch head and the consumer only tail
+        struct Stub final : Task
+        {
+            void run() override {}
+        };
+
+        Stub stub;
+        alignas(64) std::atomic<Task*> head;
+        alignas(64) Task* tail;
+        std::atomic<bool> wakePending = false;
+        std::size_t batchLimit;
+        std::thread::id mainThread;
+    };
+
+    template<typename Fun>
+    void MainThreadExecutor::post(Fun&& fun)
+    {
+        using Stored = std::decay_t<Fun>;
+        push(new FunctionTask<Stored>(Stored(std::forward<Fun>(fun))));
+    }
+
+    template<typename Fun>
+    std::future<std::invoke_result_t<std::decay_t<Fun>&>> MainThreadExecutor::submit(Fun&& fun)
+    {
+        using Return = std::invoke_result_t<std::decay_t<Fun>&>;
+        std::packaged_task<Return()> task(std::forward<Fun>(fun));
+        auto future = task.get_future();
+        push(new FunctionTask<std::packaged_task<Return()>>(std::move(task)));
+        return future;
+    }
+
+    template<typename Fun>
+    void MainThreadExecutor::dispatch(Fun&& fun)
+    {
+        if(isMainThread())
+        {
+            std::forward<Fun>(fun)();
+            return;
+        }
+        post(std::forward<Fun>(fun));
+    }
+}
@@ -0,0 +1,81 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <cstdint>
+
+export module glfw:frame;
+
+import :window;
+
+export namespace glfw
+{
+    // Frame intervals measured by a FrameScheduler, in seconds
+    struct FrameStats
+    {
+        uint64_t frames; // Intervals measured since the last reset
+        uint64_t missed; // Frames that started more than a whole period late
+        double mean;
+        double deviation; // Standard deviation of the interval
+        double jitter; // Mean absolute difference between the interval and the target period
+        double min;
+        double max;
+    };
+
+    // Paces a render loop to a target rate without burning a core. Most of the wait is spent blocked in
+    //  waitEventsTimeout, so events are still handled as they arrive, and only the last stretch before the deadline
+    //  spins on the timer. While the window is unfocused the background rate is used instead and while it is
+    //  iconified the loop blocks in waitEvents until something happens.
+    class FrameScheduler
+    {
+    public:
+        explicit FrameScheduler(Window& window, double rate = 0.0); // A rate of 0 follows the monitor refresh rate
+
+        void setTargetRate(double rate); // 0 follows the refresh rate of the window's monitor or the primary one
+        [[nodiscard]] double getTargetRate() const; // The rate currently paced to, after resolving the refresh rate
+        void setBackgroundRate(double rate); // 0 blocks like iconified, the default is 10
+        [[nodiscard]] double getBackgroundRate() const;
+        void setSpinThreshold(double seconds); // Time before the deadline spent spinning instead of waiting
+        [[nodiscard]] double getSpinThreshold() const;
+
+        void waitForNextFrame(); // Handles events until the next frame is due, call once per frame before rendering
+
+        [[nodiscard]] FrameStats getStats() const;
+        void resetStats();
+
+    private:
+        [[nodiscard]] double resolveRate() const;
+        void waitUntil(uint64_t deadline);
+        void measure(uint64_t now, double period);
+
+        Window window; // A copy, so the window stays alive for as long as the scheduler
+        double targetRate;
+        double backgroundRate = 10.0;
+        uint64_t spinTicks;
+        uint64_t frequency;
+        uint64_t deadline = 0;
+        uint64_t lastFrame = 0;
+
+        FrameStats stats{};
+        double sumSquares = 0.0; // Welford running sum of squared differences from the mean
+    };
+}
@@ -23,8 +23,24 @@ module;
 export module glfw;
 
 export import :type;
+export import :instrument;
+export import :event;
+export import :coroutine;
 export import :library;
+export import :executor;
 export import :monitor;
+export import :image;
 export import :cursor;
+export import :hint;
 export import :window;
 export import :joystick;
+export import :frame;
+export import :animation;
+export import :latency;
+export import :render;
+export import :context;
+export import :group;
+#ifdef GLFW_CPP_VULKAN
+export import :vulkan;
+#endif
+export import :record;
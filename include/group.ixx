@@ -0,0 +1,70 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+export module glfw:group;
+
+import :type;
+import :hint;
+import :window;
+
+export namespace glfw
+{
+    // Seconds spent in each phase of creating a WindowGroup, summed over all of its windows
+    struct WindowGroupTiming
+    {
+        double hints;
+        double create; // glfwCreateWindow, usually the bulk of it
+        double setup; // Making each context current and running the setup function, GL loading included
+        double show; // Only set once show has been called
+    };
+
+    using WindowSetupFunction = std::function<void(Window& window, std::size_t index)>;
+
+    // Creates many windows from one config in a single pass. Every window is created hidden so the compositor lays
+    //  them out once when show is called rather than once per window. Setup runs with each window's context current,
+    //  and the getProcAddress lookups made while setting up the first window are handed on to the rest, as contexts
+    //  created from the same config resolve GL functions the same way, so loading GL again costs hash lookups.
+    //  Afterwards the window hints are those of the config and the previously current context is current again.
+    class WindowGroup
+    {
+    public:
+        WindowGroup(const WindowConfig& config, std::size_t count, Size size, const char* title,
+                    WindowSetupFunction setup = nullptr, Window* share = nullptr);
+
+        void show(); // Shows every window back to back
+
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] Window& operator[](std::size_t index);
+        [[nodiscard]] std::span<Window> getWindows();
+        [[nodiscard]] const WindowGroupTiming& getTiming() const;
+
+    private:
+        std::vector<Window> windows;
+        WindowGroupTiming timing{};
+    };
+}
@@ -0,0 +1,276 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <GLFW/glfw3.h>
+
+export module glfw:hint;
+
+import :type;
+
+namespace glfw
+{
+    // Which kind of value each hint takes, these replace the runtime switches that were in checks.h
+    enum class HintKind
+    {
+        UNKNOWN,
+        BOOLEAN,
+        INTEGER,
+        ENUM,
+        STRING,
+    };
+
+    constexpr HintKind getHintKind(WindowHint hint)
+    {
+        switch(hint)
+        {
+            case WindowHint::RESIZABLE:
+            case WindowHint::VISIBLE:
+            case WindowHint::DECORATED:
+            case WindowHint::FOCUSED:
+            case WindowHint::AUTO_ICONIFY:
+            case WindowHint::FLOATING:
+            case WindowHint::STEREO:
+            case WindowHint::SRGB_CAPABLE:
+            case WindowHint::DOUBLEBUFFER:
+            case WindowHint::OPENGL_FORWARD_COMPAT:
+            case WindowHint::OPENGL_DEBUG_CONTEXT:
+            case WindowHint::MAXIMIZED:
+            case WindowHint::CENTER_CURSOR:
+            case WindowHint::TRANSPARENT_FRAMEBUFFER:
+            case WindowHint::FOCUS_ON_SHOW:
+            case WindowHint::SCALE_TO_MONITOR:
+            case WindowHint::SCALE_FRAMEBUFFER:
+            case WindowHint::MOUSE_PASSTHROUGH:
+            case WindowHint::WIN32_SHOWDEFAULT:
+            case WindowHint::WIN32_KEYBOARD_MENU:
+            case WindowHint::COCOA_GRAPHICS_SWITCHING:
+                return HintKind::BOOLEAN;
+
+            case WindowHint::RED_BIT:
+            case WindowHint::GREEN_BITS:
+            case WindowHint::BLUE_BITS:
+            case WindowHint::ALPHA_BITS:
+            case WindowHint::DEPTH_BITS:
+            case WindowHint::STENCIL_BITS:
+            case WindowHint::ACCUM_RED_BITS:
+            case WindowHint::ACCUM_GREEN_BITS:
+            case WindowHint::ACCUM_BLUE_BITS:
+            case WindowHint::ACCUM_ALPHA_BITS:
+            case WindowHint::AUX_BUFFERS:
+            case WindowHint::SAMPLES:
+            case WindowHint::REFRESH_RATE:
+            case WindowHint::CONTEXT_VERSION_MAJOR:
+            case WindowHint::CONTEXT_VERSION_MINOR:
+            case WindowHint::POSITION_X:
+            case WindowHint::POSITION_Y:
+                return HintKind::INTEGER;
+
+            case WindowHint::CLIENT_API:
+            case WindowHint::CONTEXT_CREATION_API:
+            case WindowHint::CONTEXT_ROBUSTNESS:
+            case WindowHint::CONTEXT_RELEASE_BEHAVIOR:
+            case WindowHint::OPENGL_PROFILE:
+                return HintKind::ENUM;
+
+            case WindowHint::COCOA_FRAME_NAME:
+            case WindowHint::WAYLAND_APP_ID:
+            case WindowHint::X11_CLASS_NAME:
+            case WindowHint::X11_INSTANCE_NAME:
+                return HintKind::STRING;
+
+            default:
+                return HintKind::UNKNOWN;
+        }
+    }
+
+    constexpr bool validateHintBoolean(WindowHint hint)
+    {
+        return getHintKind(hint) == HintKind::BOOLEAN;
+    }
+
+    constexpr bool validateHintString(WindowHint hint)
+    {
+        return getHintKind(hint) == HintKind::STRING;
+    }
+
+    constexpr bool validateHintInt(WindowHint hint)
+    {
+        return getHintKind(hint) == HintKind::INTEGER;
+    }
+
+    constexpr bool validateHintEnum(WindowHint hint)
+    {
+        // Integer hints take DONT_CARE, the value check sorts out the rest
+        return getHintKind(hint) == HintKind::ENUM || getHintKind(hint) == HintKind::INTEGER;
+    }
+
+    constexpr bool validateHintValue(WindowHint hint, int value)
+    {
+        switch(hint)
+        {
+            case WindowHint::POSITION_X:
+            case WindowHint::POSITION_Y:
+                return true; // Negative positions are valid with several monitors, ANY_POSITION is INT_MIN
+
+            case WindowHint::CONTEXT_CREATION_API:
+                return value == GLFW_NATIVE_CONTEXT_API || value == GLFW_EGL_CONTEXT_API ||
+                       value == GLFW_OSMESA_CONTEXT_API;
+
+            case WindowHint::CLIENT_API:
+                return value == GLFW_OPENGL_API || value == GLFW_OPENGL_ES_API || value == GLFW_NO_API;
+
+            case WindowHint::CONTEXT_ROBUSTNESS:
+                return value == GLFW_NO_ROBUSTNESS || value == GLFW_NO_RESET_NOTIFICATION ||
+                       value == GLFW_LOSE_CONTEXT_ON_RESET;
+
+            case WindowHint::CONTEXT_RELEASE_BEHAVIOR:
+                return value == GLFW_ANY_RELEASE_BEHAVIOR || value == GLFW_RELEASE_BEHAVIOR_FLUSH ||
+                       value == GLFW_RELEASE_BEHAVIOR_NONE;
+
+            case WindowHint::OPENGL_PROFILE:
+                return value == GLFW_OPENGL_ANY_PROFILE || value == GLFW_OPENGL_COMPAT_PROFILE ||
+                       value == GLFW_OPENGL_CORE_PROFILE;
+
+            default:
+                switch(getHintKind(hint))
+                {
+                    case HintKind::BOOLEAN:
+                        return value == GLFW_TRUE || value == GLFW_FALSE;
+                    case HintKind::INTEGER:
+                        return value == GLFW_DONT_CARE || value >= 0;
+                    default:
+                        return false;
+                }
+        }
+    }
+
+    // Every hint a WindowConfig can hold, its position here is its bit in the config
+    constexpr std::array HINTS
+    {
+        WindowHint::RESIZABLE, WindowHint::VISIBLE, WindowHint::DECORATED, WindowHint::FOCUSED,
+        WindowHint::AUTO_ICONIFY, WindowHint::FLOATING, WindowHint::MAXIMIZED, WindowHint::CENTER_CURSOR,
+        WindowHint::TRANSPARENT_FRAMEBUFFER, WindowHint::FOCUS_ON_SHOW, WindowHint::SCALE_TO_MONITOR,
+        WindowHint::SCALE_FRAMEBUFFER, WindowHint::MOUSE_PASSTHROUGH, WindowHint::POSITION_X, WindowHint::POSITION_Y,
+        WindowHint::RED_BIT, WindowHint::GREEN_BITS, WindowHint::BLUE_BITS, WindowHint::ALPHA_BITS,
+        WindowHint::DEPTH_BITS, WindowHint::STENCIL_BITS, WindowHint::ACCUM_RED_BITS, WindowHint::ACCUM_GREEN_BITS,
+        WindowHint::ACCUM_BLUE_BITS, WindowHint::ACCUM_ALPHA_BITS, WindowHint::AUX_BUFFERS, WindowHint::SAMPLES,
+        WindowHint::REFRESH_RATE, WindowHint::STEREO, WindowHint::SRGB_CAPABLE, WindowHint::DOUBLEBUFFER,
+        WindowHint::CLIENT_API, WindowHint::CONTEXT_CREATION_API, WindowHint::CONTEXT_VERSION_MAJOR,
+        WindowHint::CONTEXT_VERSION_MINOR, WindowHint::CONTEXT_ROBUSTNESS, WindowHint::CONTEXT_RELEASE_BEHAVIOR,
+        WindowHint::OPENGL_FORWARD_COMPAT, WindowHint::OPENGL_DEBUG_CONTEXT, WindowHint::OPENGL_PROFILE,
+        WindowHint::WIN32_KEYBOARD_MENU, WindowHint::WIN32_SHOWDEFAULT, WindowHint::COCOA_FRAME_NAME,
+        WindowHint::COCOA_GRAPHICS_SWITCHING, WindowHint::WAYLAND_APP_ID, WindowHint::X11_CLASS_NAME,
+        WindowHint::X11_INSTANCE_NAME,
+    };
+    static_assert(HINTS.size() <= 64, "The set hints of a WindowConfig are kept in a 64 bit mask");
+
+    constexpr std::size_t getHintIndex(WindowHint hint)
+    {
+        std::size_t index = 0;
+        while(index < HINTS.size() && HINTS[index] != hint)
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    void invalidateAppliedHints(); // Called whenever the hints are changed outside of WindowConfig::apply
+
+    // GLFW can not read a hint back, the ones code creating its own hidden windows has to restore are tracked here
+    void trackWindowHint(int hint, int value);
+    void resetTrackedWindowHints(); // Called whenever the hints go back to their defaults
+    [[nodiscard]] bool getVisibleHint();
+}
+
+export namespace glfw
+{
+    // A complete set of window hints checked as they are added, at compile time when the config is constexpr, and
+    //  applied in one call. Applying the same config again with no hints changed in between does nothing, so
+    //  creating many identically configured windows costs one round of hints. Hints left unset keep their defaults.
+    //  String hints are kept by pointer until applied.
+    class WindowConfig
+    {
+    public:
+        constexpr WindowConfig() = default;
+
+        constexpr WindowConfig& hint(WindowHint hint, bool value)
+        {
+            return set(hint, validateHintBoolean(hint), value ? GLFW_TRUE : GLFW_FALSE);
+        }
+
+        constexpr WindowConfig& hint(WindowHint hint, WindowValue value)
+        {
+            return set(hint, validateHintEnum(hint) && validateHintValue(hint, static_cast<int>(value)),
+                       static_cast<int>(value));
+        }
+
+        constexpr WindowConfig& hint(WindowHint hint, int value)
+        {
+            return set(hint, validateHintValue(hint, value), value);
+        }
+
+        constexpr WindowConfig& hint(WindowHint hint, const char* value)
+        {
+            if(!validateHintString(hint) || value == nullptr)
+            {
+                throw std::invalid_argument("Window hint does not take a string");
+            }
+            auto index = getHintIndex(hint);
+            strings[index] = value;
+            mask |= uint64_t{1} << index;
+            return *this;
+        }
+
+        [[nodiscard]] constexpr bool has(WindowHint hint) const
+        {
+            auto index = getHintIndex(hint);
+            return index < HINTS.size() && (mask & uint64_t{1} << index) != 0;
+        }
+
+        void apply() const; // Resets every hint to its default before setting this config's
+
+        [[nodiscard]] bool operator==(const WindowConfig& other) const; // Compares string hints by content
+
+    private:
+        constexpr WindowConfig& set(WindowHint hint, bool valid, int value)
+        {
+            // Throwing is not a constant expression, which is what turns a bad hint into a compile error
+            if(!valid)
+            {
+                throw std::invalid_argument("Window hint does not take this value");
+            }
+            auto index = getHintIndex(hint);
+            values[index] = value;
+            mask |= uint64_t{1} << index;
+            return *this;
+        }
+
+        std::array<int, HINTS.size()> values{};
+        std::array<const char*, HINTS.size()> strings{};
+        uint64_t mask = 0;
+    };
+}
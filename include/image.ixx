@@ -0,0 +1,94 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <cstddef>
+#include <span>
+#include <GLFW/glfw3.h>
+
+export module glfw:image;
+
+import :type;
+
+export namespace glfw
+{
+    enum class PixelFormat
+    {
+        RGBA8, // What GLFW expects, straight alpha
+        BGRA8,
+        RGB8,
+        BGR8,
+        RGBA8_PREMULTIPLIED,
+        BGRA8_PREMULTIPLIED,
+        RGBA32F, // Straight alpha, channels clamped to [0, 1]
+    };
+
+    [[nodiscard]] constexpr std::size_t getPixelSize(PixelFormat format)
+    {
+        switch(format)
+        {
+            case PixelFormat::RGB8:
+            case PixelFormat::BGR8:
+                return 3;
+            case PixelFormat::RGBA32F:
+                return 16;
+            default:
+                return 4;
+        }
+    }
+
+    // Owned RGBA8 pixels in the layout GLFW wants for cursors and icons. Buffers come from a pool of 64 byte aligned
+    //  blocks so loading many small images reuses memory instead of hitting the allocator for each one.
+    class Image
+    {
+    public:
+        Image() = default;
+        Image(int width, int height); // Transparent black
+        Image(int width, int height, PixelFormat format, const void* pixels, std::size_t stride = 0); // Stride 0 is packed
+        ~Image();
+
+        Image(const Image& other);
+        Image& operator=(const Image& other);
+        Image(Image&& other) noexcept;
+        Image& operator=(Image&& other) noexcept;
+
+        // Converts into the existing pixels, reallocating only when the size changes
+        void assign(int width, int height, PixelFormat format, const void* pixels, std::size_t stride = 0);
+
+        [[nodiscard]] int getWidth() const;
+        [[nodiscard]] int getHeight() const;
+        [[nodiscard]] std::span<unsigned char> getPixels();
+        [[nodiscard]] std::span<const unsigned char> getPixels() const;
+
+        operator ImageView() const; // NOLINT(*-explicit-constructor)
+        explicit operator bool() const; // Explicit so Cursor(image) does not also match Cursor(int)
+
+    private:
+        void reset(int width, int height);
+
+        int width = 0;
+        int height = 0;
+        unsigned char* pixels = nullptr;
+    };
+
+    void trimImagePool(); // Frees pooled buffers no image is using
+}
@@ -0,0 +1,121 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <GLFW/glfw3.h>
+
+export module glfw:instrument;
+
+export namespace glfw
+{
+    // True when the library was built with GLFW_CPP_INSTRUMENTATION, otherwise nothing is ever recorded
+#ifdef GLFW_CPP_INSTRUMENTATION
+    constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+    constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+    enum class Metric : uint8_t
+    {
+        POLL_EVENTS, // pollEvents including the work done by the event hooks
+        SWAP_BUFFERS, // Time blocked in swapBuffers
+        FRAME_INTERVAL, // Between consecutive swapBuffers returns
+        DISPATCH_KEY, // Callback function run time per event type
+        DISPATCH_CHAR,
+        DISPATCH_MOUSE_BUTTON,
+        DISPATCH_CURSOR_POS,
+        DISPATCH_SCROLL,
+        DISPATCH_WINDOW_SIZE,
+        DISPATCH_FRAMEBUFFER_SIZE,
+        DISPATCH_FOCUS,
+        COUNT,
+    };
+
+    // Log linear histogram of nanosecond durations, each power of two is split into 8 buckets so any reported
+    //  percentile is within 12.5% of the true value. Recording is a few relaxed atomic adds and reading is allowed
+    //  from any thread while other threads record.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr std::size_t SUB_BUCKETS = 8;
+        static constexpr std::size_t BUCKETS = (64 - 2) * SUB_BUCKETS;
+
+        LatencyHistogram() = default;
+
+        // Disable copy and assignment, the counters are shared between threads by address
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        void record(uint64_t nanoseconds);
+        void reset(); // Not atomic as a whole, records made while resetting may be partly kept
+
+        [[nodiscard]] uint64_t getCount() const;
+        [[nodiscard]] uint64_t getMax() const;
+        [[nodiscard]] double getMean() const;
+        [[nodiscard]] uint64_t getPercentile(double percentile) const; // Upper bound of the bucket, percentile in 0-100
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> count = 0;
+        std::atomic<uint64_t> sum = 0;
+        std::atomic<uint64_t> max = 0;
+    };
+
+    [[nodiscard]] const LatencyHistogram& getHistogram(Metric metric);
+    [[nodiscard]] const char* getMetricName(Metric metric);
+    void resetHistograms();
+    [[nodiscard]] std::string histogramsToJson();
+    [[nodiscard]] std::string histogramsToCsv();
+}
+
+namespace glfw
+{
+    void recordTicks(Metric metric, uint64_t ticks);
+
+    // Times its scope into a metric. Compiled out it is an empty object, the timer is never even read.
+#ifdef GLFW_CPP_INSTRUMENTATION
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Metric metric) : metric(metric), start(glfwGetTimerValue()) {}
+        ~ScopedTimer()
+        {
+            recordTicks(metric, glfwGetTimerValue() - start);
+        }
+
+    private:
+        Metric metric;
+        uint64_t start;
+    };
+#else
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Metric) {}
+    };
+#endif
+}
@@ -20,17 +20,29 @@
 
 module;
 
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <span>
+#include <vector>
 #include <GLFW/glfw3.h>
 
 export module glfw:joystick;
 
+import :coroutine;
 import :type;
 
+namespace glfw
+{
+    // Termination clears the GLFW joystick callback, it is installed again on the next use
+    void resetJoystickCallback();
+}
+
 export namespace glfw
 {
     JoystickFunction* setJoystickCallback(JoystickFunction* callback = nullptr);
     inline void updateGamepadMappings(const char* string);
+    inline Result<void> tryUpdateGamepadMappings(const char* string); // Non-throwing variant
 
     class Joystick
     {
@@ -43,18 +55,111 @@ export namespace glfw
         [[nodiscard]] int get() const;
 
         [[nodiscard]] bool present() const;
-        const float* getAxes(int *count) const; // TODO: sub object again?
-        const unsigned char* getButtons(int *count); // TODO: convert to vector
-        const unsigned char* getHats(int *count); // TODO: convert to vector
+        const float* getAxes(int *count) const;
+        const unsigned char* getButtons(int *count);
+        const unsigned char* getHats(int *count);
+        [[nodiscard]] std::span<const float> getAxes() const; // Valid until the next call for this joystick
+        [[nodiscard]] std::span<const unsigned char> getButtons() const; // Valid until the next call for this joystick
+        [[nodiscard]] std::span<const unsigned char> getHats() const; // Valid until the next call for this joystick
         const char* getName();
         const char* getGUID();
         bool isGamepad();
         const char* getGamepadName();
         GamepadState getGamepadState();
+        Result<GamepadState> tryGetGamepadState(); // Error code is NONE when the joystick is absent or not a gamepad
         void setUserPointer(void* pointer);
         [[nodiscard]] void* getUserPointer() const;
 
     private:
         int jid;
     };
+
+    // Copy of the state of every joystick taken in one pass, so code reading it never calls back into GLFW. Each kind
+    //  of state is its own cache aligned block indexed by joystick, unused slots are zero. Nothing is allocated, a
+    //  snapshot can be captured into the same object every poll.
+    class JoystickSnapshot
+    {
+    public:
+        static constexpr int JOYSTICK_COUNT = GLFW_JOYSTICK_LAST + 1;
+        static constexpr int MAX_AXES = 32; // Extra axes, buttons or hats a device reports are left out
+        static constexpr int MAX_BUTTONS = 128;
+        static constexpr int MAX_HATS = 8;
+
+        void capture();
+
+        [[nodiscard]] bool present(Joystick joystick) const;
+        [[nodiscard]] bool isGamepad(Joystick joystick) const;
+        [[nodiscard]] uint16_t getPresentMask() const; // Bit n is set when joystick n is present
+        [[nodiscard]] std::span<const float> getAxes(Joystick joystick) const;
+        [[nodiscard]] std::span<const unsigned char> getButtons(Joystick joystick) const;
+        [[nodiscard]] std::span<const unsigned char> getHats(Joystick joystick) const;
+        [[nodiscard]] const GamepadState& getGamepadState(Joystick joystick) const; // Zero unless isGamepad
+
+    private:
+        friend class JoystickMonitor;
+
+        alignas(64) std::array<std::array<float, MAX_AXES>, JOYSTICK_COUNT> axes{};
+        alignas(64) std::array<std::array<unsigned char, MAX_BUTTONS>, JOYSTICK_COUNT> buttons{};
+        alignas(64) std::array<std::array<unsigned char, MAX_HATS>, JOYSTICK_COUNT> hats{};
+        alignas(64) std::array<GamepadState, JOYSTICK_COUNT> gamepadStates{};
+        alignas(64) std::array<uint8_t, JOYSTICK_COUNT> axisCounts{};
+        std::array<uint8_t, JOYSTICK_COUNT> buttonCounts{};
+        std::array<uint8_t, JOYSTICK_COUNT> hatCounts{};
+        uint16_t presentMask = 0;
+        uint16_t gamepadMask = 0;
+    };
+
+    enum class JoystickEventType : uint8_t
+    {
+        CONNECTED,
+        DISCONNECTED,
+        BUTTON_PRESSED,
+        BUTTON_RELEASED,
+        AXIS_MOVED,
+        HAT_CHANGED,
+        GAMEPAD_BUTTON_PRESSED,
+        GAMEPAD_BUTTON_RELEASED,
+        GAMEPAD_AXIS_MOVED,
+    };
+
+    struct JoystickEvent
+    {
+        JoystickEventType type;
+        uint8_t joystick;
+        uint8_t index; // Button, axis or hat index, unused for connection events
+        uint8_t hat; // New hat state for HAT_CHANGED
+        float value; // New axis value for the axis events
+    };
+
+    // Captures a JoystickSnapshot every update and turns the difference from the last one into edge events, so
+    //  consumers only react to what changed. Axis events fire once an axis has moved further than the epsilon from
+    //  the value last reported for it, slow drift is still reported once it adds up.
+    class JoystickMonitor
+    {
+    public:
+        explicit JoystickMonitor(float axisEpsilon = 0.01f);
+
+        void setAxisEpsilon(float epsilon);
+        [[nodiscard]] float getAxisEpsilon() const;
+
+        std::span<const JoystickEvent> update(); // Valid until the next update
+        std::span<const JoystickEvent> update(const JoystickSnapshot& snapshot); // Diffs a snapshot captured elsewhere
+        [[nodiscard]] const JoystickSnapshot& getSnapshot() const; // The snapshot the last update diffed against
+
+    private:
+        std::span<const JoystickEvent> diff();
+
+        std::array<JoystickSnapshot, 2> snapshots{};
+        std::size_t current = 0;
+        using AxisRows = std::array<std::array<float, JoystickSnapshot::MAX_AXES>, JoystickSnapshot::JOYSTICK_COUNT>;
+        using GamepadAxisRows =
+                std::array<std::array<float, GLFW_GAMEPAD_AXIS_LAST + 1>, JoystickSnapshot::JOYSTICK_COUNT>;
+        alignas(64) AxisRows reportedAxes{};
+        alignas(64) GamepadAxisRows reportedGamepadAxes{};
+        float axisEpsilon;
+        std::vector<JoystickEvent> events;
+    };
+
+    // Resumes a Task coroutine with the joystick after the event loop iteration in which one connected
+    [[nodiscard]] EventAwaiter<Joystick> joystickConnected();
 }
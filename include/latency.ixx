@@ -0,0 +1,92 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <GLFW/glfw3.h>
+
+export module glfw:latency;
+
+import :event;
+import :instrument;
+import :window;
+
+export namespace glfw
+{
+    // Measures how long key, char, mouse button, cursor pos and scroll events take to reach a presented frame. Every
+    //  event is timestamped as it arrives from GLFW, tagged with the current frame and closed when the swapBuffers
+    //  that presents that frame returns. Without beginFrame each swap presents every event tagged so far, with it
+    //  events arriving after the frame's input was read wait for the next swap. With finish enabled glFinish is called
+    //  after the swap so the time includes the GPU finishing the frame, this needs the window's context to be current
+    //  when swapBuffers is called.
+    class LatencyTracker
+    {
+    public:
+        static constexpr std::size_t MAX_PENDING = 256; // Events beyond this in one frame are counted as dropped
+
+        explicit LatencyTracker(Window& window, bool finish = false);
+        ~LatencyTracker();
+
+        // Disable copy and assignment, the window points back at the tracker
+        LatencyTracker(const LatencyTracker&) = delete;
+        LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+        void setFinish(bool finish);
+        [[nodiscard]] bool getFinish() const;
+
+        void beginFrame(); // Call once the frame's input was read, later events are tagged with the next frame
+        [[nodiscard]] uint64_t getFrame() const; // Id of the frame events are currently tagged with
+        [[nodiscard]] uint64_t getPresentedCount() const;
+        [[nodiscard]] uint64_t getDroppedCount() const;
+        [[nodiscard]] const LatencyHistogram& getHistogram(EventType type) const;
+        [[nodiscard]] std::string toJson() const;
+        void reset();
+
+    private:
+        friend class Window;
+
+        void tag(EventType type);
+        void present();
+
+        struct Tag
+        {
+            EventType type;
+            uint64_t frame;
+            uint64_t time;
+        };
+
+        std::weak_ptr<WindowCallbacks> callbacks; // Lets the tracker outlive its window
+        bool finish;
+        GLFWglproc glFinish = nullptr; // Resolved from the context the first time it is needed
+
+        uint64_t frame = 0;
+        uint64_t presented = 0; // Also the id of the frame the next swap presents
+        uint64_t dropped = 0;
+        std::size_t pendingCount = 0;
+        std::array<Tag, MAX_PENDING> pending{};
+        std::array<LatencyHistogram, static_cast<std::size_t>(EventType::FOCUS) + 1> histograms;
+    };
+}
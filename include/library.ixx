@@ -27,19 +27,35 @@ export module glfw:library;
 
 import :type;
 
+namespace glfw
+{
+    // Hooks run after every pollEvents, waitEvents and waitEventsTimeout so other parts of the wrapper can finish work
+    //  that was batched up while GLFW was dispatching events.
+    using EventHook = void(*)(void* user);
+    void addEventHook(EventHook hook, void* user);
+    void removeEventHook(EventHook hook, void* user);
+
+    // Reapplies the window hints the library options imply, called again whenever the hints are reset to defaults
+    void applyLibraryWindowHints();
+}
+
 export namespace glfw
 {
 
+    inline void initHint(InitHint hint, bool value); // Type checked/convince overload
+    inline void initHint(InitHint hint, InitValue value); // Type checked/convince overload
+    inline void initHint(InitHint hint, Platform value); // Type checked/convince overload
     inline void initHint(int hint, int value);
     inline void initAllocator(const Allocator *allocator);
-    // inline void glfwInitVulkanLoader(PFN_vkGetInstanceProcAddr loader) // TODO
     [[nodiscard]] constexpr Version getCompileTimeVersion();
     [[nodiscard]] inline Version getVersion();
     [[nodiscard]] inline const char* getVersionString();
-    [[nodiscard]] inline const std::string getError(); // TODO: check what returns when there is no error
+    [[nodiscard]] inline const std::string getError(); // Empty when there is no error
+    [[nodiscard]] inline Error getLastError(); // Allocation free, clears the error like getError
     inline ErrorFun setErrorCallback(ErrorFun fun);
     inline int getPlatform();
-    bool platformSupported(int platform); // TODO: type checked method
+    bool platformSupported(Platform platform); // Type checked/convince overload
+    bool platformSupported(int platform);
     inline void pollEvents();
     inline void waitEvents();
     inline void waitEventsTimeout(double timeout);
@@ -55,19 +71,44 @@ export namespace glfw
     [[nodiscard]] inline bool extensionSupported(const char* extension);
     inline GLFWglproc getProcAddress(const char* procname);
     inline bool vulkanSupported();
-    inline const char** getRequiredInstanceExtensions(uint32_t* count);
-    // inline GLFWvkproc getInstanceProcAddress (VkInstance instance, const char *procname); // TODO:
-    // bool getPhysicalDevicePresentationSupport(VkInstance instance, VkPhysicalDevice device, uint32_t queuefamily);
-    // VkResult createWindowSurface(VkInstance instance, GLFWwindow *window, const VkAllocationCallbacks *allocator, VkSurfaceKHR *surface); // TODO: should this be part of Window instead?
+    inline const char** getRequiredInstanceExtensions(uint32_t* count); // The vulkan partition has a cached span overload
+
+    struct LibraryOptions
+    {
+        Platform platform = Platform::ANY_PLATFORM;
+        const Allocator* allocator = nullptr; // Null uses the default allocator
+        bool joystickHatButtons = true;
+        InitValue anglePlatformType = InitValue::ANGLE_PLATFORM_TYPE_NONE;
+        bool cocoaChdirResources = true;
+        bool cocoaMenubar = true;
+        bool x11XcbVulkanSurface = true;
+        InitValue waylandLibdecor = InitValue::WAYLAND_PREFER_LIBDECOR;
+
+        // Runs on the null platform with OSMesa software contexts regardless of platform, so windows, contexts,
+        //  callbacks and timers all work without a display server or GPU.
+        bool headless = false;
+    };
 
     class Library
     {
     public:
-        Library();
+        Library(); // Initializes with whatever init hints are currently set
+        explicit Library(const LibraryOptions& options);
         ~Library();
 
-        // Disable copy and assignment to ensure proper resource handling
+        // Disable copy and assignment to ensure proper resource handling, moving hands over the termination
         Library(const Library&) = delete;
         Library& operator=(const Library&) = delete;
+        Library(Library&& other) noexcept;
+        Library& operator=(Library&&) = delete;
+
+        [[nodiscard]] static Result<Library> tryCreate();
+        [[nodiscard]] static Result<Library> tryCreate(const LibraryOptions& options);
+
+    private:
+        struct Initialized {};
+        explicit Library(Initialized);
+
+        bool owner = true;
     };
 }
@@ -20,6 +20,10 @@
 
 module;
 
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
 #include <vector>
 #include <string>
 #include <glfw/glfw3.h>
@@ -30,6 +34,12 @@ export module glfw:monitor;
 
 import :type;
 
+namespace glfw
+{
+    // Drops the cached monitor snapshot and callback state, the monitors it points at are gone after termination
+    void resetMonitorRegistry();
+}
+
 export namespace glfw
 {
     class Monitor;
@@ -63,4 +73,60 @@ export namespace glfw
     private:
         GLFWmonitor* ptr;
     };
+
+    // Everything about one monitor as it was when the snapshot was taken. The spans and name point into the owning
+    //  snapshot and stay valid for as long as it is held.
+    struct MonitorInfo
+    {
+        Monitor monitor;
+        Position<int> pos;
+        WorkArea workarea;
+        Size physicalSize;
+        Scale contentScale;
+        VideoMode videoMode; // Current mode
+        std::span<const VideoMode> videoModes;
+        std::string_view name;
+    };
+
+    // Immutable view of every connected monitor. Modes and names of all monitors share one allocation each.
+    class MonitorSnapshot
+    {
+    public:
+        MonitorSnapshot() = default;
+
+        // Disable copy and assignment, the infos point into the snapshot's own storage
+        MonitorSnapshot(const MonitorSnapshot&) = delete;
+        MonitorSnapshot& operator=(const MonitorSnapshot&) = delete;
+
+        [[nodiscard]] uint64_t getVersion() const;
+        [[nodiscard]] std::span<const MonitorInfo> getMonitors() const;
+        [[nodiscard]] const MonitorInfo* getPrimary() const; // nullptr when no monitor is connected
+        [[nodiscard]] const MonitorInfo* find(Monitor monitor) const; // nullptr when not part of this snapshot
+
+    private:
+        friend class MonitorRegistry;
+
+        uint64_t version = 0;
+        std::vector<MonitorInfo> monitors;
+        std::vector<VideoMode> videoModes;
+        std::string names;
+        std::size_t primary = 0;
+    };
+
+    // Process wide cache of the monitor topology. The snapshot is rebuilt lazily the first time it is requested after
+    //  a monitor connects or disconnects, every other request only hands out the cached one. Work areas and content
+    //  scales can change without a connection event, call invalidate when the application learns of such a change.
+    //  Like the rest of the monitor functions this must be used from the main thread, snapshots can be read anywhere.
+    class MonitorRegistry
+    {
+    public:
+        MonitorRegistry() = delete;
+
+        [[nodiscard]] static std::shared_ptr<const MonitorSnapshot> getSnapshot();
+        [[nodiscard]] static uint64_t getVersion(); // Version the next getSnapshot will return
+        static void invalidate();
+
+    private:
+        static std::shared_ptr<const MonitorSnapshot> build(uint64_t snapshotVersion);
+    };
 }
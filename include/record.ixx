@@ -0,0 +1,122 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+module;
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+export module glfw:record;
+
+import :event;
+import :joystick;
+import :window;
+import :type;
+
+export namespace glfw
+{
+    // Records the key, char, mouse button, cursor pos, scroll, size, framebuffer size, focus and drop events of the
+    //  attached windows as they arrive from GLFW, along with any joystick state it is asked to poll. Records are
+    //  timestamped with timer ticks, delta encoded and written to the file from a background thread.
+    class InputRecorder
+    {
+    public:
+        explicit InputRecorder(const char* path);
+        ~InputRecorder();
+
+        // Disable copy and assignment, windows point back at the recorder
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        void attach(Window& window); // Windows are numbered in attach order, attach them to the player in the same order
+        void detach(Window& window);
+        void recordJoystick(Joystick joystick); // Only writes a record when the state changed since the last poll
+        void flush(); // Hands everything recorded so far to the writer thread
+
+    private:
+        friend class Window;
+
+        void record(GLFWwindow* window, const Event& event);
+        void recordDrop(GLFWwindow* window, int count, const char* paths[]);
+        void beginRecord(uint8_t tag, GLFWwindow* window);
+        void submitIfFull();
+        void writeLoop();
+
+        struct JoystickRecord
+        {
+            bool present;
+            GamepadState state;
+        };
+
+        std::vector<GLFWwindow*> windows;
+        std::vector<std::weak_ptr<WindowCallbacks>> windowCallbacks; // Lets the recorder outlive its windows
+        std::vector<Position<double>> lastCursorPos;
+        std::array<JoystickRecord, GLFW_JOYSTICK_LAST + 1> joysticks{};
+        uint64_t lastTime;
+        std::vector<uint8_t> buffer; // Filled on the main thread
+
+        std::ofstream file;
+        std::vector<uint8_t> pending; // Handed to the writer thread
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+        std::thread writer;
+    };
+
+    // Plays a trace written by InputRecorder back through the GLFW callbacks currently installed on the attached
+    //  windows, so everything downstream of them behaves as it did while recording.
+    class InputPlayer
+    {
+    public:
+        explicit InputPlayer(const char* path);
+
+        void attach(Window& window); // Must match the attach order used while recording
+        void setSpeed(double speed); // 1 plays at the recorded speed, 0 plays everything on the next update
+        void start(); // Starts or restarts playback from the beginning of the trace
+        bool update(); // Injects every event that is due, returns false once the trace is finished
+        [[nodiscard]] bool finished() const;
+        [[nodiscard]] bool joystickPresent(Joystick joystick) const;
+        [[nodiscard]] const GamepadState& getGamepadState(Joystick joystick) const; // Last replayed state
+
+    private:
+        void inject(uint8_t tag, GLFWwindow* window);
+
+        std::vector<uint8_t> data;
+        std::size_t offset = 0;
+        std::size_t begin = 0;
+        uint64_t frequency = 0;
+
+        std::vector<GLFWwindow*> windows;
+        std::vector<Position<double>> lastCursorPos;
+        std::array<bool, GLFW_JOYSTICK_LAST + 1> present{};
+        std::array<GamepadState, GLFW_JOYSTICK_LAST + 1> states{};
+
+        double speed = 1.0;
+        uint64_t startTime = 0;
+        uint64_t traceTime = 0;
+    };
+}
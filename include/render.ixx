@@ -0,0 +1,146 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+
+export module glfw:render;
+
+import :type;
+import :window;
+
+export namespace glfw
+{
+    // Latest value exchange between one producer and one consumer thread. The producer fills the back buffer and
+    //  publishes it, the consumer picks up the newest published buffer, neither ever blocks or waits for the other.
+    //  Buffers that were published but never picked up are overwritten.
+    template<typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() = default;
+
+        // Disable copy and assignment, the buffers are shared between threads by address
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        T& write() // Producer only
+        {
+            return buffers[back];
+        }
+
+        void publish() // Producer only
+        {
+            back = middle.exchange(back | DIRTY, std::memory_order_acq_rel) & INDEX;
+        }
+
+        bool update() // Consumer only, returns true when a newer buffer was picked up
+        {
+            if(!(middle.load(std::memory_order_relaxed) & DIRTY))
+            {
+                return false;
+            }
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+            return true;
+        }
+
+        [[nodiscard]] const T& read() const // Consumer only
+        {
+            return buffers[front];
+        }
+
+    private:
+        static constexpr uint8_t INDEX = 0x3;
+        static constexpr uint8_t DIRTY = 0x4;
+
+        std::array<T, 3> buffers{};
+        alignas(64) std::atomic<uint8_t> middle = 1;
+        alignas(64) uint8_t back = 0;
+        alignas(64) uint8_t front = 2;
+    };
+
+    struct RenderFrame
+    {
+        uint64_t frame; // Frames rendered before this one
+        Size framebufferSize;
+        bool resized; // The framebuffer size changed since the previous frame
+    };
+
+    // Owns a window's context on a thread of its own, rendering and swapping there while the main thread keeps
+    //  handling events. Per frame input reaches the render function through a TripleBuffer. The window is kept alive
+    //  until the render thread has stopped and released the context, afterwards no context is current on any thread.
+    class RenderThread
+    {
+    public:
+        using RenderFunction = std::function<void(Window& window, const RenderFrame& frame)>;
+
+        // A swap interval below zero leaves the context's interval as it is
+        RenderThread(Window& window, RenderFunction render, int swapInterval = -1);
+
+        // Picks up the newest input published to the buffer before every frame and passes it to the render function
+        //  as a third argument. The main thread writes and publishes, the buffer must outlive the render thread.
+        template<typename T, typename Fun>
+        RenderThread(Window& window, TripleBuffer<T>& input, Fun render, int swapInterval = -1);
+        ~RenderThread(); // Stops after the frame in progress and joins
+
+        // Disable copy and assignment, the window and thread point back at the render thread
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        void stop();
+        [[nodiscard]] bool isRunning() const;
+        [[nodiscard]] uint64_t getFrameCount() const;
+        void rethrow(); // Rethrows on the calling thread whatever the render function threw, if it threw
+
+    private:
+        friend class Window;
+
+        void resize(Size size);
+        void run(int swapInterval);
+
+        Window window;
+        RenderFunction render;
+        std::atomic<uint64_t> framebufferSize; // Width in the high half, height in the low half
+        std::atomic<bool> resized = false;
+        std::atomic<bool> stopping = false;
+        std::atomic<bool> running = true;
+        std::atomic<uint64_t> frames = 0;
+        std::exception_ptr failure;
+        std::thread thread;
+    };
+
+    template<typename T, typename Fun>
+    RenderThread::RenderThread(Window& window, TripleBuffer<T>& input, Fun render, int swapInterval)
+            : RenderThread(window, [&input, render = std::move(render)](Window& window, const RenderFrame& frame) mutable
+            {
+                input.update();
+                render(window, frame, input.read());
+            }, swapInterval)
+    {
+    }
+}
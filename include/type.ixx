@@ -20,7 +20,10 @@
 
 module;
 
+#include <cassert>
 #include <functional>
+#include <utility>
+#include <variant>
 #include <GLFW/glfw3.h>
 
 export module glfw:type;
@@ -30,6 +33,11 @@ export namespace glfw
     class Window;
     class Joystick;
     class Monitor;
+    class InputRecorder;
+    class LatencyTracker;
+    class RenderThread;
+    class Surface;
+    class AnimatedCursor;
 
     enum class ConnectionEvent
     {
@@ -218,7 +226,7 @@ export namespace glfw
     // Redefine structs to be within our namespace
     using ErrorFun = GLFWerrorfun;
     using glProc = GLFWglproc;
-    using Image = GLFWimage;
+    using ImageView = GLFWimage; // Non-owning, the owned Image is in the image partition
     using VideoMode = GLFWvidmode;
     using GammaRamp = GLFWgammaramp;
 
@@ -380,9 +388,44 @@ export namespace glfw
         X11_INSTANCE_NAME = GLFW_X11_INSTANCE_NAME,
     };
 
+    enum class Platform
+    {
+        ANY_PLATFORM = GLFW_ANY_PLATFORM,
+        PLATFORM_WIN32 = GLFW_PLATFORM_WIN32,
+        PLATFORM_COCOA = GLFW_PLATFORM_COCOA,
+        PLATFORM_WAYLAND = GLFW_PLATFORM_WAYLAND,
+        PLATFORM_X11 = GLFW_PLATFORM_X11,
+        PLATFORM_NULL = GLFW_PLATFORM_NULL,
+    };
+
+    enum class InitHint
+    {
+        PLATFORM = GLFW_PLATFORM,
+        JOYSTICK_HAT_BUTTONS = GLFW_JOYSTICK_HAT_BUTTONS,
+        ANGLE_PLATFORM_TYPE = GLFW_ANGLE_PLATFORM_TYPE,
+        COCOA_CHDIR_RESOURCES = GLFW_COCOA_CHDIR_RESOURCES,
+        COCOA_MENUBAR = GLFW_COCOA_MENUBAR,
+        X11_XCB_VULKAN_SURFACE = GLFW_X11_XCB_VULKAN_SURFACE,
+        WAYLAND_LIBDECOR = GLFW_WAYLAND_LIBDECOR,
+    };
+
+    enum class InitValue
+    {
+        ANGLE_PLATFORM_TYPE_NONE = GLFW_ANGLE_PLATFORM_TYPE_NONE,
+        ANGLE_PLATFORM_TYPE_OPENGL = GLFW_ANGLE_PLATFORM_TYPE_OPENGL,
+        ANGLE_PLATFORM_TYPE_OPENGLES = GLFW_ANGLE_PLATFORM_TYPE_OPENGLES,
+        ANGLE_PLATFORM_TYPE_D3D9 = GLFW_ANGLE_PLATFORM_TYPE_D3D9,
+        ANGLE_PLATFORM_TYPE_D3D11 = GLFW_ANGLE_PLATFORM_TYPE_D3D11,
+        ANGLE_PLATFORM_TYPE_VULKAN = GLFW_ANGLE_PLATFORM_TYPE_VULKAN,
+        ANGLE_PLATFORM_TYPE_METAL = GLFW_ANGLE_PLATFORM_TYPE_METAL,
+        WAYLAND_PREFER_LIBDECOR = GLFW_WAYLAND_PREFER_LIBDECOR,
+        WAYLAND_DISABLE_LIBDECOR = GLFW_WAYLAND_DISABLE_LIBDECOR,
+    };
+
     enum class WindowValue
     {
         DONT_CARE = GLFW_DONT_CARE,
+        NO_API = GLFW_NO_API,
         OPENGL_API = GLFW_OPENGL_API,
         OPENGL_ES_API = GLFW_OPENGL_ES_API,
         NO_ROBUSTNESS = GLFW_NO_ROBUSTNESS,
@@ -394,5 +437,126 @@ export namespace glfw
         OPENGL_ANY_PROFILE = GLFW_OPENGL_ANY_PROFILE,
         OPENGL_COMPAT_PROFILE = GLFW_OPENGL_COMPAT_PROFILE,
         OPENGL_CORE_PROFILE = GLFW_OPENGL_CORE_PROFILE,
+        NATIVE_CONTEXT_API = GLFW_NATIVE_CONTEXT_API,
+        EGL_CONTEXT_API = GLFW_EGL_CONTEXT_API,
+        OSMESA_CONTEXT_API = GLFW_OSMESA_CONTEXT_API,
+    };
+
+    enum class ErrorCode
+    {
+        NONE = GLFW_NO_ERROR, // Not NO_ERROR, that is a macro on Windows
+        NOT_INITIALIZED = GLFW_NOT_INITIALIZED,
+        NO_CURRENT_CONTEXT = GLFW_NO_CURRENT_CONTEXT,
+        INVALID_ENUM = GLFW_INVALID_ENUM,
+        INVALID_VALUE = GLFW_INVALID_VALUE,
+        OUT_OF_MEMORY = GLFW_OUT_OF_MEMORY,
+        API_UNAVAILABLE = GLFW_API_UNAVAILABLE,
+        VERSION_UNAVAILABLE = GLFW_VERSION_UNAVAILABLE,
+        PLATFORM_ERROR = GLFW_PLATFORM_ERROR,
+        FORMAT_UNAVAILABLE = GLFW_FORMAT_UNAVAILABLE,
+        NO_WINDOW_CONTEXT = GLFW_NO_WINDOW_CONTEXT,
+        CURSOR_UNAVAILABLE = GLFW_CURSOR_UNAVAILABLE,
+        FEATURE_UNAVAILABLE = GLFW_FEATURE_UNAVAILABLE,
+        FEATURE_UNIMPLEMENTED = GLFW_FEATURE_UNIMPLEMENTED,
+        PLATFORM_UNAVAILABLE = GLFW_PLATFORM_UNAVAILABLE,
+    };
+
+    // The description is owned by GLFW or is a string literal, it stays valid until the next error on the same
+    //  thread or until the library is terminated. It is never null.
+    struct Error
+    {
+        ErrorCode code;
+        const char* description;
+    };
+
+    // Either a value or the error that prevented it, returned by the non-throwing try variants. Neither creating one
+    //  nor reading the error allocates or throws.
+    template<typename T>
+    class [[nodiscard]] Result
+    {
+    public:
+        Result(T value) : data(std::in_place_index<0>, std::move(value)) {} // NOLINT(*-explicit-constructor)
+        Result(Error error) : data(std::in_place_index<1>, error) {} // NOLINT(*-explicit-constructor)
+
+        [[nodiscard]] bool hasValue() const
+        {
+            return data.index() == 0;
+        }
+
+        explicit operator bool() const
+        {
+            return hasValue();
+        }
+
+        [[nodiscard]] T& value() &
+        {
+            assert(hasValue());
+            return *std::get_if<0>(&data);
+        }
+
+        [[nodiscard]] const T& value() const &
+        {
+            assert(hasValue());
+            return *std::get_if<0>(&data);
+        }
+
+        [[nodiscard]] T&& value() &&
+        {
+            assert(hasValue());
+            return std::move(*std::get_if<0>(&data));
+        }
+
+        T* operator->()
+        {
+            return &value();
+        }
+
+        const T* operator->() const
+        {
+            return &value();
+        }
+
+        [[nodiscard]] const Error& error() const
+        {
+            assert(!hasValue());
+            return *std::get_if<1>(&data);
+        }
+
+        template<typename U>
+        [[nodiscard]] T valueOr(U&& fallback) const &
+        {
+            return hasValue() ? value() : static_cast<T>(std::forward<U>(fallback));
+        }
+
+    private:
+        std::variant<T, Error> data;
+    };
+
+    template<>
+    class [[nodiscard]] Result<void>
+    {
+    public:
+        Result() : failure{ErrorCode::NONE, ""}, failed(false) {}
+        Result(Error error) : failure(error), failed(true) {} // NOLINT(*-explicit-constructor)
+
+        [[nodiscard]] bool hasValue() const
+        {
+            return !failed;
+        }
+
+        explicit operator bool() const
+        {
+            return hasValue();
+        }
+
+        [[nodiscard]] const Error& error() const
+        {
+            assert(failed);
+            return failure;
+        }
+
+    private:
+        Error failure;
+        bool failed;
     };
 }
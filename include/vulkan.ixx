@@ -0,0 +1,91 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+export module glfw:vulkan;
+
+import :type;
+import :window;
+
+namespace glfw
+{
+    void resetVulkanCache(); // Called on terminate, the extension array GLFW handed out is freed with it
+}
+
+export namespace glfw
+{
+    using VulkanProc = GLFWvkproc;
+
+    // Must be called before the library is initialized, a stub loader lets Vulkan paths run without a driver. On the
+    //  null platform GLFW only asks the loader for VK_EXT_headless_surface.
+    inline void initVulkanLoader(PFN_vkGetInstanceProcAddr loader);
+
+    // Queried once and kept until terminate, empty when Vulkan is not available
+    [[nodiscard]] std::span<const char* const> getRequiredInstanceExtensions();
+    [[nodiscard]] inline VulkanProc getInstanceProcAddress(VkInstance instance, const char* procname);
+    [[nodiscard]] inline bool getPhysicalDevicePresentationSupport(VkInstance instance, VkPhysicalDevice device,
+                                                                   uint32_t queueFamily);
+
+    // Owns a VkSurfaceKHR and keeps the window it was created for alive until the surface is destroyed, which Vulkan
+    //  requires. The destroy function is looked up through the same loader GLFW uses.
+    class Surface
+    {
+    public:
+        Surface() = default;
+        Surface(VkInstance instance, const Window& window, const VkAllocationCallbacks* allocator = nullptr);
+        ~Surface();
+
+        // Disable copy and assignment, a surface has exactly one owner
+        Surface(const Surface&) = delete;
+        Surface& operator=(const Surface&) = delete;
+        Surface(Surface&& other) noexcept;
+        Surface& operator=(Surface&& other) noexcept;
+
+        [[nodiscard]] static Result<Surface> tryCreate(VkInstance instance, const Window& window,
+                                                       const VkAllocationCallbacks* allocator = nullptr);
+
+        void reset(); // Destroys the surface and lets go of the window
+
+        [[nodiscard]] VkSurfaceKHR get() const;
+        [[nodiscard]] VkInstance getInstance() const;
+
+        operator VkSurfaceKHR() const; // NOLINT(*-explicit-constructor)
+        operator bool() const; // NOLINT(*-explicit-constructor)
+
+    private:
+        struct Created {};
+        Surface(Created, VkInstance instance, const Window& window, const VkAllocationCallbacks* allocator,
+                VkSurfaceKHR surface);
+
+        VkInstance instance = VK_NULL_HANDLE;
+        VkSurfaceKHR surface = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* allocator = nullptr;
+        PFN_vkDestroySurfaceKHR destroy = nullptr;
+        std::shared_ptr<WindowCallbacks> window; // Keeps the window alive through its state, which also owns the handle
+    };
+}
@@ -20,14 +20,22 @@
 
 module;
 
+#include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <GLFW\glfw3.h>
 
 export module glfw:window;
 
 import :monitor;
+import :coroutine;
 import :cursor;
+import :event;
+import :image;
 import :type;
 
 namespace glfw
@@ -36,6 +44,17 @@ namespace glfw
     {
         void operator()(GLFWwindow* ptr);
     };
+
+    // Copies of the window properties layout code reads every frame, kept current by the dispatchers
+    struct WindowProperties
+    {
+        Position<int> pos;
+        Size size;
+        Size framebufferSize;
+        Scale contentScale;
+        FrameSize frameSize; // No event reports this, read again by refresh, setAttrib and setMonitor
+        float opacity; // No event reports this either, read again by setOpacity
+    };
 }
 
 export namespace glfw
@@ -54,27 +73,7 @@ export namespace glfw
 
     inline Window* getCurrentContext();
 
-    struct WindowCallbacks
-    {
-        WindowPosFunction windowPosFunction;
-        WindowSizeFunction windowSizeFunction;
-        WindowCloseFunction windowCloseFunction;
-        WindowRefreshFunction windowRefreshFunction;
-        WindowFocusFunction windowFocusFunction;
-        WindowIconifyFunction windowIconifyFunction;
-        WindowMaximizeFunction windowMaximizeFunction;
-        FrameBufferSizeFunction windowFrameBufferSizeFunction;
-        WindowContentScaleFunction windowContentScaleFunction;
-
-        KeyFunction keyFunction;
-        CharFunction charFunction;
-        CharModsFunction charModsFunction;
-        MouseButtonFunction mouseButtonFunction;
-        CursorPosFunction cursorPosFunction;
-        CursorEnterFunction cursorEnterFunction;
-        ScrollFunction scrollFunction;
-        DropFunction dropFunction;
-    };
+    struct WindowCallbacks;
 
     class Window
     {
@@ -83,17 +82,25 @@ export namespace glfw
         Window(int width, int height, const char* title, Monitor* monitor = nullptr, Window* share = nullptr);
         explicit Window(GLFWwindow* window);
 
+        // Non-throwing variant of the constructor above
+        [[nodiscard]] static Result<Window> tryCreate(int width, int height, const char* title,
+                Monitor* monitor = nullptr, Window* share = nullptr);
+
         GLFWwindow* get() const;
         operator GLFWwindow*() const; // NOLINT(*-explicit-constructor)
         operator bool() const; // NOLINT(*-explicit-constructor)
 
-        Window& operator=(const Window&) = default;
+        Window(const Window& other);
+        Window& operator=(const Window& other);
+        ~Window();
 
         [[nodiscard]] bool shouldClose() const;
         void setShouldClose(bool value);
         [[nodiscard]] const char* getTitle() const;
         void setTitle(const char* title) const;
-        void setIcon(const std::vector<Image>& images); // TODO: implement once Image is implemented, does it need to be optional?
+        void setIcon(std::span<const Image> images); // GLFW picks the sizes closest to what the platform wants
+        void setIcon(std::span<const ImageView> images);
+        void resetIcon(); // Back to the default icon
         [[nodiscard]] Position<int> getPos() const;
         void setPos(Position<int> pos);
         [[nodiscard]] Size getSize() const;
@@ -138,7 +145,8 @@ export namespace glfw
         [[nodiscard]] KeyAction getMouseButton(MouseButton button) const; // TODO: type checked method
         [[nodiscard]] Position<double> getCursorPos() const;
         void setCursorPos(Position<double> pos);
-        void setCursor(Cursor* cursor = nullptr); // TODO: check if we can pass a glfw cursor to this method, if not we may need to use the other type as we don't want to force us holding the object
+        void setCursor(Cursor* cursor = nullptr);
+        void setCursor(CursorHandle cursor); // Cached cursors, the window does not hold on to the cursor either way
         KeyFunction setKeyCallback(KeyFunction callback);
         CharFunction setCharCallback(CharFunction callback);
         CharModsFunction setCharModsCallback(CharModsFunction callback);
@@ -147,6 +155,48 @@ export namespace glfw
         CursorEnterFunction setCursorEnterCallback(CursorEnterFunction callback);
         ScrollFunction setScrollCallback(ScrollFunction callback);
         DropFunction setDropCallback(DropFunction callback);
+
+        // Queued mode records key, char, mouse button, cursor pos, scroll, size, framebuffer size and focus events
+        //  into a fixed capacity ring instead of dispatching them to their callbacks.
+        void enableEventQueue(std::size_t capacity = 1024);
+        void disableEventQueue();
+        [[nodiscard]] bool isEventQueueEnabled() const;
+        [[nodiscard]] std::span<const Event> drainEvents(); // Valid until the next call to drainEvents
+        [[nodiscard]] uint64_t getDroppedEventCount() const;
+
+        // Cached mode answers getPos, getSize, getFramebufferSize, getFrameSize, getContentScale and getOpacity from
+        //  copies updated by the window events instead of asking the platform, which can be a server round trip.
+        //  Changes made through setPos or setSize show up once their event arrives, refresh re-reads everything.
+        void enablePropertyCache();
+        void disablePropertyCache();
+        [[nodiscard]] bool isPropertyCacheEnabled() const;
+        void refresh();
+
+        // Binds every onPos, onSize, onClose, onRefresh, onFocus, onIconify, onMaximize, onFramebufferSize,
+        //  onContentScale, onKey, onChar, onCharMods, onMouseButton, onCursorPos, onCursorEnter, onScroll and onDrop
+        //  member the handler declares, with the same parameters as the matching callback function. Each one gets its
+        //  own GLFW callback for the handler type so the call is direct and can be inlined. The handler must outlive
+        //  the binding, bound events bypass the callback functions, queued mode and coalescing until unbind is called.
+        //  They still reach the property cache, awaiters, recorder and latency tracker. Binding again replaces the
+        //  previous handler, events only it declared go back to the callback functions.
+        template<typename Handler>
+        void bind(Handler& handler);
+        void unbind();
+
+        // Coalescing merges cursor pos and scroll events between polls into one delivery made when pollEvents,
+        //  waitEvents or waitEventsTimeout returns. Pending motion is also flushed before any key, char or mouse
+        //  button event so ordering between them is kept.
+        void setCoalesceMode(CoalesceMode mode);
+        [[nodiscard]] CoalesceMode getCoalesceMode() const;
+        [[nodiscard]] const CoalescedInput& getCoalescedInput() const;
+        [[nodiscard]] CoalesceStats getCoalesceStats() const;
+        void flushCoalescedInput();
+
+        // Awaitables for Task coroutines, each resumes after the pollEvents, waitEvents or waitEventsTimeout that
+        //  received the event, whether it went to a callback function or a bound handler.
+        [[nodiscard]] EventAwaiter<KeyEvent> nextKey();
+        [[nodiscard]] EventAwaiter<MouseButtonEvent> nextMouseButton();
+        [[nodiscard]] EventAwaiter<Size> framebufferResized();
         void setClipboardString(const char* string);
         [[nodiscard]] const char* getClipboardString();
         void makeContextCurrent();
@@ -154,8 +204,317 @@ export namespace glfw
 
         // TODO: should glfwCreateWindowSurface go in here? it kinda matches so possibly?
     private:
+        friend class InputRecorder;
+        friend class FrameScheduler;
+        friend class LatencyTracker;
+        friend class RenderThread;
+        friend class Surface;
+        friend class AnimatedCursor;
+
+        static Window* fromHandle(GLFWwindow* ptr);
+
+        // Everything besides delivery that an event feeds, latency tracking, coalescing order, the window state, the
+        //  recorder and the awaiters. Called by the dispatchers and the bound handler trampolines alike so binding a
+        //  handler never starves them.
+        static void observe(Window& window, const Event& event);
+        static void observeDrop(Window& window, int count, const char* paths[]);
+        static void updateProperties(Window& window, const Event& event); // The window state part of observe
+
+        bool coalesceCursorPos(Position<double> pos);
+        bool coalesceScroll(Position<double> offset);
+        void dispatchCursorPos(Position<double> pos);
+        void dispatchScroll(Position<double> offset);
+
         std::shared_ptr<GLFWwindow> ptr;
-        void* user = nullptr;
         std::shared_ptr<WindowCallbacks> callbacks;
     };
+
+    struct WindowCallbacks : std::enable_shared_from_this<WindowCallbacks>
+    {
+        WindowPosFunction windowPosFunction;
+        WindowSizeFunction windowSizeFunction;
+        WindowCloseFunction windowCloseFunction;
+        WindowRefreshFunction windowRefreshFunction;
+        WindowFocusFunction windowFocusFunction;
+        WindowIconifyFunction windowIconifyFunction;
+        WindowMaximizeFunction windowMaximizeFunction;
+        FrameBufferSizeFunction windowFrameBufferSizeFunction;
+        WindowContentScaleFunction windowContentScaleFunction;
+
+        KeyFunction keyFunction;
+        CharFunction charFunction;
+        CharModsFunction charModsFunction;
+        MouseButtonFunction mouseButtonFunction;
+        CursorPosFunction cursorPosFunction;
+        CursorEnterFunction cursorEnterFunction;
+        ScrollFunction scrollFunction;
+        DropFunction dropFunction;
+
+        std::unique_ptr<EventQueue> eventQueue; // Only set while the window is in queued mode
+        std::unique_ptr<WindowProperties> properties; // Only set while the window caches its properties
+        void* boundHandler = nullptr; // Only set while a handler is bound, see Window::bind
+
+        CoalesceMode coalesceMode = CoalesceMode::NONE;
+        CoalescedInput coalescePending{}; // Folded since the last flush
+        CoalescedInput coalesced{}; // Delivered by the last flush
+        CoalesceStats coalesceStats{};
+        Position<double> lastCursorPos{};
+
+        InputRecorder* recorder = nullptr; // Only set while the window is attached to a recorder
+
+        AwaiterList<KeyEvent> keyAwaiters;
+        AwaiterList<MouseButtonEvent> mouseButtonAwaiters;
+        AwaiterList<Size> framebufferSizeAwaiters;
+
+        LatencyTracker* latencyTracker = nullptr; // Only set while a tracker is attached
+        RenderThread* renderThread = nullptr; // Only set while a render thread owns the context
+        std::atomic<uint64_t> lastSwap = 0; // Timer value of the previous swap, for the frame interval metric
+
+        bool focused = false; // Kept current from creation, see Window::updateProperties
+        bool iconified = false;
+
+        void* user = nullptr;
+
+        // The GLFW user pointer is set once to this state, which every copy shares, and the dispatchers hand this
+        //  Window to the callbacks. It holds the handle but not the state, so anything keeping the state from a Window
+        //  takes it through shared_from_this. Copies of the Window do that themselves.
+        Window window;
+    };
+
+    inline Window* Window::fromHandle(GLFWwindow* ptr)
+    {
+        auto callbacks = static_cast<WindowCallbacks*>(glfwGetWindowUserPointer(ptr));
+        return callbacks ? &callbacks->window : nullptr;
+    }
+
+    template<typename Handler>
+    void Window::bind(Handler& handler)
+    {
+        assert(ptr.get() != nullptr);
+
+        // Events bound for a previous handler type would cast the new handler to the old type
+        unbind();
+        callbacks->boundHandler = &handler;
+
+        if constexpr(requires(Handler h, Window w) { h.onPos(w, Position<int>{}); })
+        {
+            glfwSetWindowPosCallback(ptr.get(), [](GLFWwindow* ptr, int x, int y)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::WINDOW_POS};
+                    event.pos = {x, y};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onPos(*window, event.pos);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onSize(w, Size{}); })
+        {
+            glfwSetWindowSizeCallback(ptr.get(), [](GLFWwindow* ptr, int w, int h)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::WINDOW_SIZE};
+                    event.size = {w, h};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onSize(*window, event.size);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onClose(w); })
+        {
+            glfwSetWindowCloseCallback(ptr.get(), [](GLFWwindow* ptr)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onClose(*window);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onRefresh(w); })
+        {
+            glfwSetWindowRefreshCallback(ptr.get(), [](GLFWwindow* ptr)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onRefresh(*window);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onFocus(w, true); })
+        {
+            glfwSetWindowFocusCallback(ptr.get(), [](GLFWwindow* ptr, int f)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::FOCUS};
+                    event.focused = f == GLFW_TRUE;
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onFocus(*window, event.focused);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onIconify(w, true); })
+        {
+            glfwSetWindowIconifyCallback(ptr.get(), [](GLFWwindow* ptr, int i)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::ICONIFY};
+                    event.iconified = i == GLFW_TRUE;
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onIconify(*window, event.iconified);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onMaximize(w, true); })
+        {
+            glfwSetWindowMaximizeCallback(ptr.get(), [](GLFWwindow* ptr, int m)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onMaximize(*window, m == GLFW_TRUE);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onFramebufferSize(w, Size{}); })
+        {
+            glfwSetFramebufferSizeCallback(ptr.get(), [](GLFWwindow* ptr, int w, int h)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::FRAMEBUFFER_SIZE};
+                    event.size = {w, h};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onFramebufferSize(*window, event.size);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onContentScale(w, Scale{}); })
+        {
+            glfwSetWindowContentScaleCallback(ptr.get(), [](GLFWwindow* ptr, float x, float y)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::CONTENT_SCALE};
+                    event.contentScale = {x, y};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onContentScale(*window, event.contentScale);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onKey(w, Key{}, 0, KeyAction{}, 0); })
+        {
+            glfwSetKeyCallback(ptr.get(), [](GLFWwindow* ptr, int key, int scancode, int action, int mods)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::KEY};
+                    event.key = {static_cast<Key>(key), scancode, static_cast<KeyAction>(action), mods};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onKey(*window, static_cast<Key>(key), scancode, static_cast<KeyAction>(action), mods);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onChar(w, 0u); })
+        {
+            glfwSetCharCallback(ptr.get(), [](GLFWwindow* ptr, unsigned int codepoint)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::CHAR};
+                    event.codepoint = codepoint;
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onChar(*window, codepoint);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onCharMods(w, 0u, 0); })
+        {
+            glfwSetCharModsCallback(ptr.get(), [](GLFWwindow* ptr, unsigned int codepoint, int mods)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onCharMods(*window, codepoint, mods);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onMouseButton(w, MouseButton{}, KeyAction{}, 0); })
+        {
+            glfwSetMouseButtonCallback(ptr.get(), [](GLFWwindow* ptr, int button, int action, int mods)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::MOUSE_BUTTON};
+                    event.mouseButton = {static_cast<MouseButton>(button), static_cast<KeyAction>(action), mods};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onMouseButton(*window, static_cast<MouseButton>(button), static_cast<KeyAction>(action), mods);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onCursorPos(w, Position<double>{}); })
+        {
+            glfwSetCursorPosCallback(ptr.get(), [](GLFWwindow* ptr, double xpos, double ypos)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::CURSOR_POS};
+                    event.cursorPos = {xpos, ypos};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onCursorPos(*window, event.cursorPos);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onCursorEnter(w, true); })
+        {
+            glfwSetCursorEnterCallback(ptr.get(), [](GLFWwindow* ptr, int e)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onCursorEnter(*window, e == GLFW_TRUE);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w) { h.onScroll(w, Position<double>{}); })
+        {
+            glfwSetScrollCallback(ptr.get(), [](GLFWwindow* ptr, double xoffset, double yoffset)
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    Event event{EventType::SCROLL};
+                    event.scroll = {xoffset, yoffset};
+                    observe(*window, event);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onScroll(*window, event.scroll);
+                }
+            });
+        }
+
+        if constexpr(requires(Handler h, Window w, const char* paths[]) { h.onDrop(w, 0, paths); })
+        {
+            glfwSetDropCallback(ptr.get(), [](GLFWwindow* ptr, int path_count, const char* paths[])
+            {
+                if(auto window = fromHandle(ptr))
+                {
+                    observeDrop(*window, path_count, paths);
+                    static_cast<Handler*>(window->callbacks->boundHandler)->onDrop(*window, path_count, paths);
+                }
+            });
+        }
+    }
 }
@@ -0,0 +1,197 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <span>
+#include <thread>
+#include <utility>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        uint64_t toTicks(double seconds)
+        {
+            return std::max<uint64_t>(static_cast<uint64_t>(seconds * static_cast<double>(glfwGetTimerFrequency())), 1);
+        }
+    }
+
+    AnimatedCursor::AnimatedCursor(Window& window, std::span<const ImageView> frames, Position<int> posHot,
+                                   double frameDuration) : window(window), posHot(posHot),
+                                   frameTicks(toTicks(frameDuration)), frameCount(frames.size())
+    {
+        assert(window.get() != nullptr);
+        assert(!frames.empty());
+        cursors.reserve(frames.size());
+        for(auto& image : frames)
+        {
+            cursors.emplace_back(image, posHot);
+        }
+        start = heldSince = glfwGetTimerValue();
+    }
+
+    AnimatedCursor::AnimatedCursor(Window& window, std::size_t frameCount, CursorFrameDecoder decoder,
+                                   Position<int> posHot, double frameDuration) : window(window), posHot(posHot),
+                                   frameTicks(toTicks(frameDuration)), frameCount(frameCount), decoded(frameCount)
+    {
+        assert(window.get() != nullptr);
+        assert(frameCount > 0);
+        cursors.reserve(frameCount);
+
+        thread = std::thread(&AnimatedCursor::decode, this, std::move(decoder));
+    }
+
+    AnimatedCursor::~AnimatedCursor()
+    {
+        cancel.store(true, std::memory_order_relaxed);
+        if(thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    void AnimatedCursor::decode(CursorFrameDecoder decoder)
+    {
+        try
+        {
+            for(std::size_t i = 0; i < decoded.size() && !cancel.load(std::memory_order_relaxed); ++i)
+            {
+                decoded[i] = decoder(i);
+                decodedCount.store(i + 1, std::memory_order_release);
+            }
+        }
+        catch(...)
+        {
+            // Read by update only after the thread is joined
+            failure = std::current_exception();
+            cancel.store(true, std::memory_order_release);
+        }
+    }
+
+    void AnimatedCursor::update()
+    {
+        if(!isReady())
+        {
+            // Builds every frame decoded so far, the images are not needed once their cursor exists
+            auto available = decodedCount.load(std::memory_order_acquire);
+            for(auto i = cursors.size(); i < available; ++i)
+            {
+                cursors.emplace_back(decoded[i], posHot);
+                decoded[i] = Image();
+            }
+
+            if(cancel.load(std::memory_order_acquire) && thread.joinable())
+            {
+                thread.join();
+            }
+            if(hasFailed())
+            {
+                // Nothing restarts the decoder, so every later update reports the same failure
+                std::rethrow_exception(failure);
+            }
+            if(!isReady())
+            {
+                return;
+            }
+            if(thread.joinable())
+            {
+                thread.join();
+            }
+            decoded = {};
+            start = heldSince = glfwGetTimerValue();
+        }
+
+        advance(glfwGetTimerValue());
+        if(frame != shown)
+        {
+            window.setCursor(CursorHandle(cursors[frame]));
+            shown = frame;
+        }
+    }
+
+    void AnimatedCursor::advance(uint64_t now)
+    {
+        auto hold = !playing || !window.callbacks->focused || window.callbacks->iconified;
+        if(hold != held)
+        {
+            if(hold)
+            {
+                heldSince = now;
+            }
+            else
+            {
+                // Resuming continues from the frame that was showing rather than jumping ahead
+                start += now - heldSince;
+            }
+            held = hold;
+        }
+
+        if(!held)
+        {
+            frame = static_cast<std::size_t>((now - start) / frameTicks % cursors.size());
+        }
+    }
+
+    void AnimatedCursor::play()
+    {
+        playing = true;
+    }
+
+    void AnimatedCursor::stop()
+    {
+        playing = false;
+    }
+
+    bool AnimatedCursor::hasFailed() const
+    {
+        // The failure is only read once the decode thread has been joined
+        return !thread.joinable() && failure != nullptr;
+    }
+
+    bool AnimatedCursor::isReady() const
+    {
+        return cursors.size() == frameCount;
+    }
+
+    bool AnimatedCursor::isPlaying() const
+    {
+        return isReady() && !held;
+    }
+
+    std::size_t AnimatedCursor::getFrame() const
+    {
+        return frame;
+    }
+
+    std::size_t AnimatedCursor::getFrameCount() const
+    {
+        return frameCount;
+    }
+}
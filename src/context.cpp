@@ -0,0 +1,286 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        // FNV-1a, proc names are short so anything heavier costs more than the probes it saves
+        uint64_t hashName(const char* name)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for(; *name != '\0'; ++name)
+            {
+                hash = (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        struct CurrentCache
+        {
+            GLFWwindow* context = nullptr;
+            ProcCache* cache = nullptr;
+            uint64_t generation = 0;
+        };
+
+        std::mutex registryMutex;
+        std::unordered_map<GLFWwindow*, std::unique_ptr<ProcCache>> registry;
+        std::atomic<uint64_t> registryGeneration = 0; // Bumped whenever a cache is dropped so no thread keeps using it
+        thread_local CurrentCache current;
+    }
+
+    template<typename T>
+    ProcCache::Slot<T>& ProcCache::Table<T>::find(uint64_t hash, const char* name)
+    {
+        if((count + 1) * 2 > slots.size())
+        {
+            std::vector<Slot<T>> old(slots.size() * 2);
+            old.swap(slots);
+            for(auto& slot : old)
+            {
+                if(slot.used)
+                {
+                    auto mask = slots.size() - 1;
+                    auto i = slot.hash & mask;
+                    while(slots[i].used)
+                    {
+                        i = (i + 1) & mask;
+                    }
+                    slots[i] = std::move(slot);
+                }
+            }
+        }
+
+        auto mask = slots.size() - 1;
+        for(auto i = hash & mask;; i = (i + 1) & mask)
+        {
+            auto& slot = slots[i];
+            if(!slot.used || (slot.hash == hash && slot.name == name))
+            {
+                return slot;
+            }
+        }
+    }
+
+    glProc ProcCache::getProcAddress(const char* procname)
+    {
+        auto hash = hashName(procname);
+        auto& slot = procs.find(hash, procname);
+        if(!slot.used)
+        {
+            // Null results are cached too, a context never gains functions it did not have at creation
+            slot = {hash, procname, glfwGetProcAddress(procname), true};
+            ++procs.count;
+        }
+        return slot.value;
+    }
+
+    bool ProcCache::extensionSupported(const char* extension)
+    {
+        auto hash = hashName(extension);
+        auto& slot = extensions.find(hash, extension);
+        if(!slot.used)
+        {
+            slot = {hash, extension, glfwExtensionSupported(extension) == GLFW_TRUE, true};
+            ++extensions.count;
+        }
+        return slot.value;
+    }
+
+    ProcCache* getProcCache()
+    {
+        auto context = glfwGetCurrentContext();
+        if(context == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto generation = registryGeneration.load(std::memory_order_acquire);
+        if(context != current.context || generation != current.generation)
+        {
+            std::lock_guard lock(registryMutex);
+            auto& cache = registry[context];
+            if(!cache)
+            {
+                cache = std::make_unique<ProcCache>();
+            }
+            current = {context, cache.get(), generation};
+        }
+        return current.cache;
+    }
+
+    void releaseProcCache(GLFWwindow* window)
+    {
+        std::lock_guard lock(registryMutex);
+        if(registry.erase(window) != 0)
+        {
+            registryGeneration.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void copyProcCache(GLFWwindow* from, GLFWwindow* to)
+    {
+        std::lock_guard lock(registryMutex);
+        auto source = registry.find(from);
+        if(source == registry.end() || from == to)
+        {
+            return;
+        }
+        // A copy rather than a shared cache, the contexts may later be current on different threads at once
+        registry[to] = std::make_unique<ProcCache>(*source->second);
+        registryGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    void resetProcCaches()
+    {
+        std::lock_guard lock(registryMutex);
+        registry.clear();
+        registryGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    ContextPool::Lease::Lease(ContextPool* pool, std::size_t index) : pool(pool), index(index),
+            previous(glfwGetCurrentContext())
+    {
+        glfwMakeContextCurrent(pool->windows[index].get());
+    }
+
+    ContextPool::Lease::Lease(Lease&& other) noexcept : pool(other.pool), index(other.index), previous(other.previous)
+    {
+        other.pool = nullptr;
+    }
+
+    ContextPool::Lease::~Lease()
+    {
+        if(pool != nullptr)
+        {
+            glfwMakeContextCurrent(previous);
+            pool->release(index);
+        }
+    }
+
+    Window& ContextPool::Lease::getWindow() const
+    {
+        assert(pool != nullptr);
+        return pool->windows[index];
+    }
+
+    ContextPool::ContextPool(Window& main, std::size_t size)
+    {
+        assert(main.get() != nullptr);
+        windows.reserve(size);
+        free.reserve(size);
+
+        auto start = glfwGetTimerValue();
+        auto visible = getVisibleHint();
+        windowHint(WindowHint::VISIBLE, false);
+        try
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                windows.emplace_back(1, 1, "", nullptr, &main);
+                free.push_back(i);
+            }
+        }
+        catch(...)
+        {
+            windowHint(WindowHint::VISIBLE, visible);
+            throw;
+        }
+        windowHint(WindowHint::VISIBLE, visible);
+        creationTime = static_cast<double>(glfwGetTimerValue() - start) / static_cast<double>(glfwGetTimerFrequency());
+    }
+
+    ContextPool::~ContextPool()
+    {
+        assert(free.size() == windows.size());
+    }
+
+    ContextPool::Lease ContextPool::acquire()
+    {
+        std::size_t index;
+        {
+            std::unique_lock lock(mutex);
+            ++acquires;
+            if(free.empty())
+            {
+                ++waits;
+                auto start = glfwGetTimerValue();
+                condition.wait(lock, [this]{ return !free.empty(); });
+                waitTicks += glfwGetTimerValue() - start;
+            }
+            index = take();
+        }
+        return {this, index};
+    }
+
+    std::optional<ContextPool::Lease> ContextPool::tryAcquire()
+    {
+        std::size_t index;
+        {
+            std::lock_guard lock(mutex);
+            if(free.empty())
+            {
+                return std::nullopt;
+            }
+            ++acquires;
+            index = take();
+        }
+        return Lease(this, index);
+    }
+
+    ContextPoolStats ContextPool::getStats() const
+    {
+        std::lock_guard lock(mutex);
+        return {windows.size(), free.size(), creationTime, acquires, waits,
+                static_cast<double>(waitTicks) / static_cast<double>(glfwGetTimerFrequency())};
+    }
+
+    std::size_t ContextPool::take()
+    {
+        auto index = free.back();
+        free.pop_back();
+        return index;
+    }
+
+    void ContextPool::release(std::size_t index)
+    {
+        {
+            std::lock_guard lock(mutex);
+            free.push_back(index);
+        }
+        condition.notify_one();
+    }
+}
@@ -0,0 +1,159 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        constexpr std::size_t FRAME_GRANULE = 64;
+        constexpr std::size_t FRAME_CLASSES = 16; // Frames up to 1 KiB are pooled, larger ones use the heap directly
+
+        struct FreeFrame
+        {
+            FreeFrame* next;
+        };
+
+        enum class PoolState : uint8_t
+        {
+            UNUSED,
+            ALIVE,
+            DESTROYED,
+        };
+
+        // Trivially destructible so it can still be read while other thread locals and statics are torn down
+        thread_local PoolState poolState = PoolState::UNUSED;
+
+        struct FramePool
+        {
+            FramePool()
+            {
+                poolState = PoolState::ALIVE;
+            }
+
+            ~FramePool()
+            {
+                poolState = PoolState::DESTROYED;
+                for(auto frame : freeFrames)
+                {
+                    while(frame != nullptr)
+                    {
+                        ::operator delete(std::exchange(frame, frame->next));
+                    }
+                }
+            }
+
+            std::array<FreeFrame*, FRAME_CLASSES> freeFrames{};
+        };
+
+        thread_local FramePool framePool;
+
+        std::vector<std::coroutine_handle<>> ready;
+        std::vector<std::coroutine_handle<>> resuming;
+        uint64_t frame = 0;
+        bool schedulerInstalled = false;
+
+        AwaiterList<uint64_t>& frameAwaiters()
+        {
+            static AwaiterList<uint64_t> awaiters;
+            return awaiters;
+        }
+
+        void resumeReady(void*)
+        {
+            frameAwaiters().complete(++frame);
+
+            // Swapped out first so coroutines awaiting again from here wait for the next iteration
+            std::swap(ready, resuming);
+            for(auto handle : resuming)
+            {
+                handle.resume();
+            }
+            resuming.clear();
+        }
+    }
+
+    void scheduleResume(std::coroutine_handle<> handle)
+    {
+        ready.push_back(handle);
+    }
+
+    void installCoroutineScheduler()
+    {
+        if(!schedulerInstalled)
+        {
+            addEventHook(resumeReady, nullptr);
+            schedulerInstalled = true;
+        }
+    }
+
+    void Task::promise_type::unhandled_exception() noexcept
+    {
+        std::terminate();
+    }
+
+    void* Task::promise_type::operator new(std::size_t size)
+    {
+        auto sizeClass = (size + FRAME_GRANULE - 1) / FRAME_GRANULE;
+        if(sizeClass > FRAME_CLASSES || poolState == PoolState::DESTROYED)
+        {
+            return ::operator new(size);
+        }
+
+        auto& head = framePool.freeFrames[sizeClass - 1];
+        if(head == nullptr)
+        {
+            return ::operator new(sizeClass * FRAME_GRANULE);
+        }
+        return std::exchange(head, head->next);
+    }
+
+    void Task::promise_type::operator delete(void* frame, std::size_t size) noexcept
+    {
+        auto sizeClass = (size + FRAME_GRANULE - 1) / FRAME_GRANULE;
+        if(sizeClass > FRAME_CLASSES || poolState != PoolState::ALIVE)
+        {
+            ::operator delete(frame);
+            return;
+        }
+
+        auto& head = framePool.freeFrames[sizeClass - 1];
+        head = ::new(frame) FreeFrame{head};
+    }
+
+    EventAwaiter<uint64_t> nextFrame()
+    {
+        installCoroutineScheduler();
+        return EventAwaiter<uint64_t>(frameAwaiters());
+    }
+}
@@ -20,7 +20,12 @@
 
 module;
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <GLFW\glfw3.h>
 
@@ -43,7 +48,7 @@ namespace glfw
         return cursor;
     }
 
-    GLFWcursor* createCursor(const Image& image, Position<int> posHot)
+    GLFWcursor* createCursor(const ImageView& image, Position<int> posHot)
     {
         auto cursor = glfwCreateCursor(&image, posHot.x, posHot.y);
         if(!cursor)
@@ -59,10 +64,35 @@ namespace glfw
 
     Cursor::Cursor(int shape) : ptr(createStandardCursor(shape)) {}
 
-    Cursor::Cursor(const Image& image, Position<int> posHot) : ptr(createCursor(image, posHot)) {}
+    Cursor::Cursor(const ImageView& image, Position<int> posHot) : ptr(createCursor(image, posHot)) {}
 
     Cursor::Cursor(GLFWcursor* cursor) : ptr(cursor) {}
 
+    Result<Cursor> Cursor::tryCreate(CursorShape shape)
+    {
+        return tryCreate(static_cast<int>(shape));
+    }
+
+    Result<Cursor> Cursor::tryCreate(int shape)
+    {
+        auto cursor = glfwCreateStandardCursor(shape);
+        if(!cursor)
+        {
+            return getLastError();
+        }
+        return Cursor(cursor);
+    }
+
+    Result<Cursor> Cursor::tryCreate(const ImageView& image, Position<int> posHot)
+    {
+        auto cursor = glfwCreateCursor(&image, posHot.x, posHot.y);
+        if(!cursor)
+        {
+            return getLastError();
+        }
+        return Cursor(cursor);
+    }
+
     Cursor::operator GLFWcursor*() const
     {
         return ptr.get();
@@ -72,4 +102,114 @@ namespace glfw
     {
         return ptr != nullptr;
     }
+
+    CursorHandle::CursorHandle(const Cursor& cursor) : cursor(cursor) {}
+
+    CursorHandle::CursorHandle(GLFWcursor* cursor) : cursor(cursor) {}
+
+    CursorHandle::operator GLFWcursor*() const
+    {
+        return cursor;
+    }
+
+    CursorHandle::operator bool() const
+    {
+        return cursor != nullptr;
+    }
+
+    namespace
+    {
+        // Eight bytes per step, cursor images are hashed on every lookup so this has to stay cheap
+        uint64_t hashCursor(const ImageView& image, Position<int> posHot)
+        {
+            auto mix = [](uint64_t hash, uint64_t value)
+            {
+                hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+                return hash * 0xff51afd7ed558ccdull;
+            };
+
+            auto hash = mix(mix(0, static_cast<uint32_t>(image.width) | static_cast<uint64_t>(image.height) << 32),
+                            static_cast<uint32_t>(posHot.x) | static_cast<uint64_t>(posHot.y) << 32);
+            auto bytes = static_cast<std::size_t>(image.width) * image.height * 4;
+            std::size_t i = 0;
+            for(; i + 8 <= bytes; i += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, image.pixels + i, 8);
+                hash = mix(hash, word);
+            }
+            for(; i < bytes; ++i)
+            {
+                hash = mix(hash, image.pixels[i]);
+            }
+            return hash;
+        }
+    }
+
+    CursorHandle CursorCache::get(CursorShape shape)
+    {
+        auto& cursor = standard[static_cast<int>(shape) - GLFW_ARROW_CURSOR];
+        if(!cursor)
+        {
+            cursor = Cursor(shape);
+        }
+        return cursor;
+    }
+
+    CursorHandle CursorCache::get(const ImageView& image, Position<int> posHot)
+    {
+        auto hash = hashCursor(image, posHot);
+        auto bytes = static_cast<std::size_t>(image.width) * image.height * 4;
+        auto [begin, end] = custom.equal_range(hash);
+        for(auto it = begin; it != end; ++it)
+        {
+            // The hash only narrows it down, two images sharing one must not share a cursor
+            auto& entry = it->second;
+            if(entry.image.getWidth() == image.width && entry.image.getHeight() == image.height &&
+               entry.posHot.x == posHot.x && entry.posHot.y == posHot.y &&
+               std::memcmp(entry.image.getPixels().data(), image.pixels, bytes) == 0)
+            {
+                return entry.cursor;
+            }
+        }
+
+        Cursor cursor(image, posHot);
+        auto it = custom.emplace(hash, Entry{Image(image.width, image.height, PixelFormat::RGBA8, image.pixels), posHot,
+                                             std::move(cursor)});
+        return it->second.cursor;
+    }
+
+    CursorHandle CursorCache::get(std::span<const ScaledCursorImage> variants, Scale scale)
+    {
+        assert(!variants.empty());
+        auto target = std::max(scale.x, scale.y);
+        const ScaledCursorImage* best = nullptr;
+        const ScaledCursorImage* largest = &variants.front();
+        for(auto& variant : variants)
+        {
+            if(variant.scale >= target && (best == nullptr || variant.scale < best->scale))
+            {
+                best = &variant;
+            }
+            if(variant.scale > largest->scale)
+            {
+                largest = &variant;
+            }
+        }
+
+        best = best == nullptr ? largest : best;
+        return get(best->image, best->posHot);
+    }
+
+    std::size_t CursorCache::size() const
+    {
+        return std::ranges::count_if(standard, [](const Cursor& cursor) { return static_cast<bool>(cursor); }) +
+               custom.size();
+    }
+
+    void CursorCache::clear()
+    {
+        standard = {};
+        custom.clear();
+    }
 }
@@ -0,0 +1,84 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+module;
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <memory>
+#include <span>
+
+module glfw;
+
+namespace glfw
+{
+    EventQueue::EventQueue(std::size_t capacity) : mask(std::bit_ceil(capacity) - 1),
+            ring(std::make_unique<Event[]>(mask + 1)), drained(std::make_unique<Event[]>(mask + 1))
+    {
+        assert(capacity > 0);
+    }
+
+    bool EventQueue::push(const Event& event)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        if(h - tail.load(std::memory_order_acquire) > mask)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        ring[h & mask] = event;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::span<const Event> EventQueue::drain()
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        auto h = head.load(std::memory_order_acquire);
+
+        // The ring may wrap so copy it out in at most two pieces, this keeps the result a single contiguous span
+        auto count = h - t;
+        auto first = t & mask;
+        auto firstCount = std::min(count, mask + 1 - first);
+        std::copy_n(&ring[first], firstCount, drained.get());
+        std::copy_n(&ring[0], count - firstCount, drained.get() + firstCount);
+
+        tail.store(h, std::memory_order_release);
+        return {drained.get(), count};
+    }
+
+    std::size_t EventQueue::capacity() const
+    {
+        return mask + 1;
+    }
+
+    std::size_t EventQueue::size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    uint64_t EventQueue::getDroppedCount() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+}
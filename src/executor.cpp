@@ -0,0 +1,157 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        void drainHook(void* user)
+        {
+            static_cast<MainThreadExecutor*>(user)->drain();
+        }
+    }
+
+    MainThreadExecutor::MainThreadExecutor(std::size_t batchLimit) : head(&stub), tail(&stub), batchLimit(batchLimit),
+            mainThread(std::this_thread::get_id())
+    {
+        addEventHook(drainHook, this);
+    }
+
+    MainThreadExecutor::~MainThreadExecutor()
+    {
+        removeEventHook(drainHook, this);
+        while(auto task = pop())
+        {
+            std::unique_ptr<Task> owned(task);
+        }
+    }
+
+    void MainThreadExecutor::link(Task* task)
+    {
+        task->next.store(nullptr, std::memory_order_relaxed);
+        auto previous = head.exchange(task, std::memory_order_acq_rel);
+        previous->next.store(task, std::memory_order_release);
+    }
+
+    void MainThreadExecutor::push(Task* task)
+    {
+        link(task);
+
+        // Only the first task since the last drain needs to wake the loop, the rest ride along with it
+        if(!wakePending.exchange(true, std::memory_order_acq_rel))
+        {
+            glfwPostEmptyEvent();
+        }
+    }
+
+    MainThreadExecutor::Task* MainThreadExecutor::pop()
+    {
+        auto task = tail;
+        auto next = task->next.load(std::memory_order_acquire);
+        if(task == &stub)
+        {
+            if(next == nullptr)
+            {
+                return nullptr;
+            }
+            tail = next;
+            task = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if(next != nullptr)
+        {
+            tail = next;
+            return task;
+        }
+
+        // A producer has swapped head but not linked it yet, pick it up on the next drain
+        if(task != head.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        // The last task can only be taken once the stub is queued behind it
+        link(&stub);
+        next = task->next.load(std::memory_order_acquire);
+        if(next != nullptr)
+        {
+            tail = next;
+            return task;
+        }
+        return nullptr;
+    }
+
+    std::size_t MainThreadExecutor::drain()
+    {
+        // Cleared first so anything posted while draining wakes the loop again
+        wakePending.store(false, std::memory_order_release);
+
+        std::size_t count = 0;
+        while(count < batchLimit)
+        {
+            auto task = pop();
+            if(task == nullptr)
+            {
+                return count;
+            }
+
+            ++count;
+            std::unique_ptr<Task> owned(task); // Still freed if the task throws
+            owned->run();
+        }
+
+        // Hit the batch limit with tasks left, make sure a waiting loop comes back around for them
+        if(tail->next.load(std::memory_order_acquire) != nullptr || tail != head.load(std::memory_order_acquire))
+        {
+            if(!wakePending.exchange(true, std::memory_order_acq_rel))
+            {
+                glfwPostEmptyEvent();
+            }
+        }
+        return count;
+    }
+
+    void MainThreadExecutor::setBatchLimit(std::size_t limit)
+    {
+        batchLimit = limit;
+    }
+
+    std::size_t MainThreadExecutor::getBatchLimit() const
+    {
+        return batchLimit;
+    }
+
+    bool MainThreadExecutor::isMainThread() const
+    {
+        return std::this_thread::get_id() == mainThread;
+    }
+}
@@ -0,0 +1,168 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        constexpr double FALLBACK_RATE = 60.0; // Used when no monitor reports a refresh rate
+    }
+
+    FrameScheduler::FrameScheduler(Window& window, double rate) : window(window), targetRate(rate),
+            frequency(glfwGetTimerFrequency())
+    {
+        assert(window.get() != nullptr);
+        setSpinThreshold(0.001);
+        resetStats();
+        deadline = lastFrame = glfwGetTimerValue();
+    }
+
+    void FrameScheduler::setTargetRate(double rate)
+    {
+        assert(rate >= 0.0);
+        targetRate = rate;
+    }
+
+    double FrameScheduler::getTargetRate() const
+    {
+        return resolveRate();
+    }
+
+    void FrameScheduler::setBackgroundRate(double rate)
+    {
+        assert(rate >= 0.0);
+        backgroundRate = rate;
+    }
+
+    double FrameScheduler::getBackgroundRate() const
+    {
+        return backgroundRate;
+    }
+
+    void FrameScheduler::setSpinThreshold(double seconds)
+    {
+        assert(seconds >= 0.0);
+        spinTicks = static_cast<uint64_t>(seconds * static_cast<double>(frequency));
+    }
+
+    double FrameScheduler::getSpinThreshold() const
+    {
+        return static_cast<double>(spinTicks) / static_cast<double>(frequency);
+    }
+
+    double FrameScheduler::resolveRate() const
+    {
+        if(targetRate > 0.0)
+        {
+            return targetRate;
+        }
+
+        // The registry snapshot is cached so following the refresh rate costs nothing per frame
+        auto snapshot = MonitorRegistry::getSnapshot();
+        auto info = snapshot->find(glfwGetWindowMonitor(window.get()));
+        if(info == nullptr)
+        {
+            info = snapshot->getPrimary();
+        }
+        return info != nullptr && info->videoMode.refreshRate > 0 ? info->videoMode.refreshRate : FALLBACK_RATE;
+    }
+
+    void FrameScheduler::waitUntil(uint64_t until)
+    {
+        // Block for everything but the last stretch, waitEventsTimeout returns early whenever an event arrives
+        for(auto now = glfwGetTimerValue(); now + spinTicks < until; now = glfwGetTimerValue())
+        {
+            waitEventsTimeout(static_cast<double>(until - spinTicks - now) / static_cast<double>(frequency));
+        }
+
+        while(glfwGetTimerValue() < until)
+        {
+            // Spin for the final sub-millisecond, the OS can not be trusted to wake a sleeping thread that precisely
+        }
+        pollEvents();
+    }
+
+    void FrameScheduler::waitForNextFrame()
+    {
+        const auto& state = *window.callbacks;
+        if(state.iconified || (!state.focused && backgroundRate <= 0.0))
+        {
+            // Nothing is visible, sleep until an event such as a restore or a focus change comes in
+            waitEvents();
+            deadline = lastFrame = glfwGetTimerValue();
+            return;
+        }
+
+        auto rate = state.focused ? resolveRate() : backgroundRate;
+        auto period = static_cast<uint64_t>(static_cast<double>(frequency) / rate);
+
+        deadline += period;
+        auto now = glfwGetTimerValue();
+        if(deadline + period < now)
+        {
+            // More than a whole frame behind, drop the lost time instead of rushing frames to catch up
+            ++stats.missed;
+            deadline = now;
+        }
+
+        waitUntil(deadline);
+        measure(glfwGetTimerValue(), static_cast<double>(period) / static_cast<double>(frequency));
+    }
+
+    void FrameScheduler::measure(uint64_t now, double period)
+    {
+        auto interval = static_cast<double>(now - lastFrame) / static_cast<double>(frequency);
+        lastFrame = now;
+
+        ++stats.frames;
+        auto frames = static_cast<double>(stats.frames);
+        auto delta = interval - stats.mean;
+        stats.mean += delta / frames;
+        sumSquares += delta * (interval - stats.mean);
+        stats.deviation = stats.frames > 1 ? std::sqrt(sumSquares / (frames - 1.0)) : 0.0;
+        stats.jitter += (std::abs(interval - period) - stats.jitter) / frames;
+        stats.min = std::min(stats.min, interval);
+        stats.max = std::max(stats.max, interval);
+    }
+
+    FrameStats FrameScheduler::getStats() const
+    {
+        return stats;
+    }
+
+    void FrameScheduler::resetStats()
+    {
+        stats = {};
+        stats.min = std::numeric_limits<double>::infinity();
+        sumSquares = 0.0;
+    }
+}
@@ -0,0 +1,121 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        double toSeconds(uint64_t ticks)
+        {
+            return static_cast<double>(ticks) / static_cast<double>(glfwGetTimerFrequency());
+        }
+
+        // Runs the function when the scope is left, whether normally or by an exception
+        template<typename Fun>
+        struct ScopeExit
+        {
+            Fun fun;
+
+            ~ScopeExit()
+            {
+                fun();
+            }
+        };
+    }
+
+    WindowGroup::WindowGroup(const WindowConfig& config, std::size_t count, Size size, const char* title,
+                             WindowSetupFunction setup, Window* share)
+    {
+        auto start = glfwGetTimerValue();
+        auto hidden = config;
+        hidden.hint(WindowHint::VISIBLE, false).apply();
+        auto created = glfwGetTimerValue();
+        timing.hints = toSeconds(created - start);
+
+        windows.reserve(count);
+        {
+            // Windows created after the group should not come out hidden
+            ScopeExit restoreHints{[&config]{ config.apply(); }};
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                windows.emplace_back(size.width, size.height, title, nullptr, share);
+            }
+        }
+        auto setupStart = glfwGetTimerValue();
+        timing.create = toSeconds(setupStart - created);
+
+        if(setup)
+        {
+            ScopeExit restoreContext{[previous = glfwGetCurrentContext()]{ glfwMakeContextCurrent(previous); }};
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                if(i > 0)
+                {
+                    copyProcCache(windows.front().get(), windows[i].get());
+                }
+                windows[i].makeContextCurrent();
+                setup(windows[i], i);
+            }
+        }
+        timing.setup = toSeconds(glfwGetTimerValue() - setupStart);
+    }
+
+    void WindowGroup::show()
+    {
+        auto start = glfwGetTimerValue();
+        for(auto& window : windows)
+        {
+            window.show();
+        }
+        timing.show = toSeconds(glfwGetTimerValue() - start);
+    }
+
+    std::size_t WindowGroup::size() const
+    {
+        return windows.size();
+    }
+
+    Window& WindowGroup::operator[](std::size_t index)
+    {
+        assert(index < windows.size());
+        return windows[index];
+    }
+
+    std::span<Window> WindowGroup::getWindows()
+    {
+        return windows;
+    }
+
+    const WindowGroupTiming& WindowGroup::getTiming() const
+    {
+        return timing;
+    }
+}
@@ -0,0 +1,130 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        // Copy of the config the current hints came from, strings copied so the caller's may go away
+        struct AppliedHints
+        {
+            bool valid = false;
+            std::array<int, HINTS.size()> values{};
+            std::array<std::string, HINTS.size()> strings{};
+            uint64_t mask = 0;
+        };
+
+        AppliedHints applied;
+        bool visibleHint = true;
+    }
+
+    void invalidateAppliedHints()
+    {
+        applied.valid = false;
+    }
+
+    void trackWindowHint(int hint, int value)
+    {
+        if(hint == GLFW_VISIBLE)
+        {
+            visibleHint = value == GLFW_TRUE;
+        }
+    }
+
+    void resetTrackedWindowHints()
+    {
+        visibleHint = true;
+    }
+
+    bool getVisibleHint()
+    {
+        return visibleHint;
+    }
+
+    bool WindowConfig::operator==(const WindowConfig& other) const
+    {
+        if(mask != other.mask)
+        {
+            return false;
+        }
+        for(auto bits = mask; bits != 0; bits &= bits - 1)
+        {
+            auto index = std::countr_zero(bits);
+            if(validateHintString(HINTS[index]) ? std::strcmp(strings[index], other.strings[index]) != 0 :
+               values[index] != other.values[index])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void WindowConfig::apply() const
+    {
+        if(applied.valid && applied.mask == mask)
+        {
+            auto same = true;
+            for(auto bits = mask; bits != 0 && same; bits &= bits - 1)
+            {
+                auto index = std::countr_zero(bits);
+                same = validateHintString(HINTS[index]) ? applied.strings[index] == strings[index] :
+                       applied.values[index] == values[index];
+            }
+            if(same)
+            {
+                return;
+            }
+        }
+
+        glfwDefaultWindowHints();
+        resetTrackedWindowHints();
+        applyLibraryWindowHints();
+        applied.mask = mask;
+        for(auto bits = mask; bits != 0; bits &= bits - 1)
+        {
+            auto index = std::countr_zero(bits);
+            auto hint = static_cast<int>(HINTS[index]);
+            if(validateHintString(HINTS[index]))
+            {
+                glfwWindowHintString(hint, strings[index]);
+                applied.strings[index] = strings[index];
+            }
+            else
+            {
+                glfwWindowHint(hint, values[index]);
+                trackWindowHint(hint, values[index]);
+                applied.values[index] = values[index];
+            }
+        }
+        applied.valid = true;
+    }
+}
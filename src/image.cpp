@@ -0,0 +1,326 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        // Power of two size classes from 256 bytes (an 8x8 image) to 64 MiB, anything larger bypasses the pool
+        constexpr std::size_t MIN_CLASS = 8;
+        constexpr std::size_t MAX_CLASS = 26;
+        constexpr std::align_val_t ALIGNMENT{64};
+
+        std::mutex poolMutex;
+        std::array<std::vector<void*>, MAX_CLASS + 1> pool;
+
+        std::size_t sizeClass(std::size_t bytes)
+        {
+            return std::max<std::size_t>(std::bit_width(std::max<std::size_t>(bytes, 1) - 1), MIN_CLASS);
+        }
+
+        unsigned char* allocatePixels(std::size_t bytes)
+        {
+            auto index = sizeClass(bytes);
+            if(index > MAX_CLASS)
+            {
+                return static_cast<unsigned char*>(::operator new(bytes, ALIGNMENT));
+            }
+
+            {
+                std::lock_guard lock(poolMutex);
+                if(!pool[index].empty())
+                {
+                    auto block = pool[index].back();
+                    pool[index].pop_back();
+                    return static_cast<unsigned char*>(block);
+                }
+            }
+            return static_cast<unsigned char*>(::operator new(std::size_t{1} << index, ALIGNMENT));
+        }
+
+        void releasePixels(unsigned char* pixels, std::size_t bytes)
+        {
+            if(pixels == nullptr)
+            {
+                return;
+            }
+
+            auto index = sizeClass(bytes);
+            if(index > MAX_CLASS)
+            {
+                ::operator delete(pixels, ALIGNMENT);
+                return;
+            }
+
+            std::lock_guard lock(poolMutex);
+            pool[index].push_back(pixels);
+        }
+
+        // The converters below work on one row with plain indexed loops over restrict pointers so the compiler can
+        //  vectorize them for whatever target it builds for, including Emscripten.
+
+        void convertSwizzle(const unsigned char* __restrict src, unsigned char* __restrict dst, std::size_t count)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                dst[i * 4 + 0] = src[i * 4 + 2];
+                dst[i * 4 + 1] = src[i * 4 + 1];
+                dst[i * 4 + 2] = src[i * 4 + 0];
+                dst[i * 4 + 3] = src[i * 4 + 3];
+            }
+        }
+
+        template<bool Swap>
+        void convertOpaque(const unsigned char* __restrict src, unsigned char* __restrict dst, std::size_t count)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                dst[i * 4 + 0] = src[i * 3 + (Swap ? 2 : 0)];
+                dst[i * 4 + 1] = src[i * 3 + 1];
+                dst[i * 4 + 2] = src[i * 3 + (Swap ? 0 : 2)];
+                dst[i * 4 + 3] = 255;
+            }
+        }
+
+        // Clamped in float and narrowed through int, a direct float to unsigned char conversion keeps GCC from
+        //  vectorizing the loops that use it. The lower bound is written so NaN fails it and maps to 0, it would
+        //  pass through std::clamp and make the int conversion undefined.
+        inline unsigned char toByte(float value)
+        {
+            value += 0.5f;
+            value = !(value > 0.0f) ? 0.0f : std::min(value, 255.0f);
+            return static_cast<unsigned char>(static_cast<int>(value));
+        }
+
+        inline unsigned char unpremultiply(unsigned char channel, float scale)
+        {
+            return static_cast<unsigned char>(std::min(static_cast<int>(channel * scale + 0.5f), 255));
+        }
+
+        template<bool Swap>
+        void convertPremultiplied(const unsigned char* __restrict src, unsigned char* __restrict dst, std::size_t count)
+        {
+            // Float reciprocal rather than a lookup table, a table lookup is a gather and stops the loop vectorizing.
+            //  Zero alpha divides by one instead without a select ahead of the divide, which trapping math would keep
+            //  as a branch, its color channels are zero already.
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                int alpha = src[i * 4 + 3];
+                float scale = 255.0f / static_cast<float>(alpha + (alpha == 0));
+                dst[i * 4 + 0] = unpremultiply(src[i * 4 + (Swap ? 2 : 0)], scale);
+                dst[i * 4 + 1] = unpremultiply(src[i * 4 + 1], scale);
+                dst[i * 4 + 2] = unpremultiply(src[i * 4 + (Swap ? 0 : 2)], scale);
+                dst[i * 4 + 3] = static_cast<unsigned char>(alpha);
+            }
+        }
+
+        void convertFloat(const float* __restrict src, unsigned char* __restrict dst, std::size_t count)
+        {
+            for(std::size_t i = 0; i < count * 4; ++i)
+            {
+                dst[i] = toByte(src[i] * 255.0f);
+            }
+        }
+
+        void convertRow(PixelFormat format, const unsigned char* src, unsigned char* dst, std::size_t count)
+        {
+            switch(format)
+            {
+                case PixelFormat::RGBA8:
+                    std::memcpy(dst, src, count * 4);
+                    break;
+                case PixelFormat::BGRA8:
+                    convertSwizzle(src, dst, count);
+                    break;
+                case PixelFormat::RGB8:
+                    convertOpaque<false>(src, dst, count);
+                    break;
+                case PixelFormat::BGR8:
+                    convertOpaque<true>(src, dst, count);
+                    break;
+                case PixelFormat::RGBA8_PREMULTIPLIED:
+                    convertPremultiplied<false>(src, dst, count);
+                    break;
+                case PixelFormat::BGRA8_PREMULTIPLIED:
+                    convertPremultiplied<true>(src, dst, count);
+                    break;
+                case PixelFormat::RGBA32F:
+                {
+                    // Rows of float data are not guaranteed to be float aligned when a stride is given
+                    float row[256 * 4];
+                    for(std::size_t offset = 0; offset < count; offset += 256)
+                    {
+                        auto chunk = std::min<std::size_t>(count - offset, 256);
+                        std::memcpy(row, src + offset * 16, chunk * 16);
+                        convertFloat(row, dst + offset * 4, chunk);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    Image::Image(int width, int height)
+    {
+        reset(width, height);
+        if(pixels != nullptr)
+        {
+            std::memset(pixels, 0, static_cast<std::size_t>(width) * height * 4);
+        }
+    }
+
+    Image::Image(int width, int height, PixelFormat format, const void* pixels, std::size_t stride)
+    {
+        assign(width, height, format, pixels, stride);
+    }
+
+    Image::~Image()
+    {
+        releasePixels(pixels, static_cast<std::size_t>(width) * height * 4);
+    }
+
+    Image::Image(const Image& other)
+    {
+        assign(other.width, other.height, PixelFormat::RGBA8, other.pixels);
+    }
+
+    Image& Image::operator=(const Image& other)
+    {
+        if(this != &other)
+        {
+            assign(other.width, other.height, PixelFormat::RGBA8, other.pixels);
+        }
+        return *this;
+    }
+
+    Image::Image(Image&& other) noexcept : width(std::exchange(other.width, 0)), height(std::exchange(other.height, 0)),
+            pixels(std::exchange(other.pixels, nullptr))
+    {
+    }
+
+    Image& Image::operator=(Image&& other) noexcept
+    {
+        if(this != &other)
+        {
+            releasePixels(pixels, static_cast<std::size_t>(width) * height * 4);
+            width = std::exchange(other.width, 0);
+            height = std::exchange(other.height, 0);
+            pixels = std::exchange(other.pixels, nullptr);
+        }
+        return *this;
+    }
+
+    void Image::assign(int width, int height, PixelFormat format, const void* pixels, std::size_t stride)
+    {
+        assert(width >= 0 && height >= 0);
+        assert(pixels != nullptr || width * height == 0);
+        reset(width, height);
+
+        auto rowSize = static_cast<std::size_t>(width) * getPixelSize(format);
+        stride = stride == 0 ? rowSize : stride;
+        assert(stride >= rowSize);
+
+        auto src = static_cast<const unsigned char*>(pixels);
+        if(stride == rowSize)
+        {
+            // Packed rows convert as one long row
+            convertRow(format, src, this->pixels, static_cast<std::size_t>(width) * height);
+            return;
+        }
+        for(int y = 0; y < height; ++y)
+        {
+            convertRow(format, src + y * stride, this->pixels + static_cast<std::size_t>(y) * width * 4, width);
+        }
+    }
+
+    void Image::reset(int width, int height)
+    {
+        auto bytes = static_cast<std::size_t>(width) * height * 4;
+        if(bytes != static_cast<std::size_t>(this->width) * this->height * 4)
+        {
+            releasePixels(pixels, static_cast<std::size_t>(this->width) * this->height * 4);
+            pixels = bytes == 0 ? nullptr : allocatePixels(bytes);
+        }
+        this->width = width;
+        this->height = height;
+    }
+
+    int Image::getWidth() const
+    {
+        return width;
+    }
+
+    int Image::getHeight() const
+    {
+        return height;
+    }
+
+    std::span<unsigned char> Image::getPixels()
+    {
+        return {pixels, static_cast<std::size_t>(width) * height * 4};
+    }
+
+    std::span<const unsigned char> Image::getPixels() const
+    {
+        return {pixels, static_cast<std::size_t>(width) * height * 4};
+    }
+
+    Image::operator ImageView() const
+    {
+        return {width, height, pixels};
+    }
+
+    Image::operator bool() const
+    {
+        return pixels != nullptr;
+    }
+
+    void trimImagePool()
+    {
+        std::lock_guard lock(poolMutex);
+        for(std::size_t index = MIN_CLASS; index <= MAX_CLASS; ++index)
+        {
+            for(auto block : pool[index])
+            {
+                ::operator delete(block, ALIGNMENT);
+            }
+            pool[index].clear();
+        }
+    }
+}
@@ -0,0 +1,215 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        std::array<LatencyHistogram, static_cast<std::size_t>(Metric::COUNT)> histograms;
+
+        constexpr std::array<const char*, static_cast<std::size_t>(Metric::COUNT)> METRIC_NAMES = {
+                "poll_events",
+                "swap_buffers",
+                "frame_interval",
+                "dispatch_key",
+                "dispatch_char",
+                "dispatch_mouse_button",
+                "dispatch_cursor_pos",
+                "dispatch_scroll",
+                "dispatch_window_size",
+                "dispatch_framebuffer_size",
+                "dispatch_focus",
+        };
+
+        std::size_t bucketIndex(uint64_t value)
+        {
+            constexpr auto SUB = LatencyHistogram::SUB_BUCKETS;
+            if(value < SUB)
+            {
+                return value;
+            }
+
+            // The top three bits below the leading one pick the sub bucket within the power of two
+            auto exponent = static_cast<std::size_t>(std::bit_width(value)) - 1;
+            auto sub = (value >> (exponent - 3)) & (SUB - 1);
+            return (exponent - 2) * SUB + sub;
+        }
+
+        uint64_t bucketUpperBound(std::size_t index)
+        {
+            constexpr auto SUB = LatencyHistogram::SUB_BUCKETS;
+            if(index < SUB)
+            {
+                return index;
+            }
+
+            auto exponent = index / SUB + 2;
+            auto lower = (SUB + index % SUB) << (exponent - 3);
+            return lower + (uint64_t(1) << (exponent - 3)) - 1;
+        }
+
+        void appendRow(std::string& out, const char* format, Metric metric)
+        {
+            const auto& histogram = histograms[static_cast<std::size_t>(metric)];
+            char row[256];
+            std::snprintf(row, sizeof(row), format, getMetricName(metric),
+                    static_cast<unsigned long long>(histogram.getCount()), histogram.getMean(),
+                    static_cast<unsigned long long>(histogram.getPercentile(50.0)),
+                    static_cast<unsigned long long>(histogram.getPercentile(95.0)),
+                    static_cast<unsigned long long>(histogram.getPercentile(99.0)),
+                    static_cast<unsigned long long>(histogram.getMax()));
+            out += row;
+        }
+    }
+
+    void LatencyHistogram::record(uint64_t nanoseconds)
+    {
+        buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+        auto current = max.load(std::memory_order_relaxed);
+        while(nanoseconds > current && !max.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void LatencyHistogram::reset()
+    {
+        for(auto& bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::getCount() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::getMax() const
+    {
+        return max.load(std::memory_order_relaxed);
+    }
+
+    double LatencyHistogram::getMean() const
+    {
+        auto samples = count.load(std::memory_order_relaxed);
+        return samples == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / samples;
+    }
+
+    uint64_t LatencyHistogram::getPercentile(double percentile) const
+    {
+        assert(percentile >= 0.0 && percentile <= 100.0);
+
+        // Summed from the buckets rather than taken from count so a concurrent record can not push the rank past them
+        uint64_t total = 0;
+        for(const auto& bucket : buckets)
+        {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        if(total == 0)
+        {
+            return 0;
+        }
+
+        auto rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for(std::size_t i = 0; i < BUCKETS; ++i)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if(seen >= rank)
+            {
+                return std::min(bucketUpperBound(i), getMax());
+            }
+        }
+        return getMax();
+    }
+
+    void recordTicks(Metric metric, uint64_t ticks)
+    {
+        static const auto frequency = glfwGetTimerFrequency();
+        auto nanoseconds = static_cast<uint64_t>(static_cast<double>(ticks) * 1e9 / static_cast<double>(frequency));
+        histograms[static_cast<std::size_t>(metric)].record(nanoseconds);
+    }
+
+    const LatencyHistogram& getHistogram(Metric metric)
+    {
+        assert(metric < Metric::COUNT);
+        return histograms[static_cast<std::size_t>(metric)];
+    }
+
+    const char* getMetricName(Metric metric)
+    {
+        assert(metric < Metric::COUNT);
+        return METRIC_NAMES[static_cast<std::size_t>(metric)];
+    }
+
+    void resetHistograms()
+    {
+        for(auto& histogram : histograms)
+        {
+            histogram.reset();
+        }
+    }
+
+    std::string histogramsToJson()
+    {
+        std::string out = "{";
+        for(std::size_t i = 0; i < histograms.size(); ++i)
+        {
+            out += i == 0 ? "\n" : ",\n";
+            appendRow(out, R"(  "%s": {"count": %llu, "mean_ns": %.1f, )"
+                    R"("p50_ns": %llu, "p95_ns": %llu, "p99_ns": %llu, "max_ns": %llu})", static_cast<Metric>(i));
+        }
+        out += "\n}\n";
+        return out;
+    }
+
+    std::string histogramsToCsv()
+    {
+        std::string out = "metric,count,mean_ns,p50_ns,p95_ns,p99_ns,max_ns\n";
+        for(std::size_t i = 0; i < histograms.size(); ++i)
+        {
+            appendRow(out, "%s,%llu,%.1f,%llu,%llu,%llu,%llu\n", static_cast<Metric>(i));
+        }
+        return out;
+    }
+}
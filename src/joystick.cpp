@@ -20,6 +20,14 @@
 
 module;
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
 #include <stdexcept>
 #include <GLFW/glfw3.h>
 
@@ -27,22 +35,98 @@ module glfw;
 
 namespace glfw
 {
-    JoystickFunction* setJoystickCallback(JoystickFunction* callback)
+    namespace
     {
-        static JoystickFunction joystickCallback = *callback;
-        if(callback)
+        // Bit i is set when entry i differs. Written as branch free loops over fixed sizes so the compiler vectorizes
+        //  them, a whole row is then handled by walking the set bits.
+        template<std::size_t N>
+        uint64_t changedMask(const unsigned char* value, const unsigned char* previous)
         {
-            glfwSetJoystickCallback([](int jid, int event)
+            static_assert(N <= 64);
+            uint64_t mask = 0;
+            for(std::size_t i = 0; i < N; ++i)
             {
-                joystickCallback(jid, static_cast<ConnectionEvent>(event));
-            });
-            return callback;
+                mask |= static_cast<uint64_t>(value[i] != previous[i]) << i;
+            }
+            return mask;
+        }
+
+        template<std::size_t N>
+        uint64_t movedMask(const float* value, const float* reported, float epsilon)
+        {
+            static_assert(N <= 64);
+            uint64_t mask = 0;
+            for(std::size_t i = 0; i < N; ++i)
+            {
+                mask |= static_cast<uint64_t>(std::abs(value[i] - reported[i]) > epsilon) << i;
+            }
+            return mask;
+        }
+
+        template<typename Emit>
+        void forEachBit(uint64_t mask, std::size_t offset, Emit&& emit)
+        {
+            for(; mask != 0; mask &= mask - 1)
+            {
+                emit(offset + std::countr_zero(mask));
+            }
+        }
+    }
+
+    namespace
+    {
+        JoystickFunction joystickFunction;
+        bool joystickCallbackInstalled = false;
+
+        AwaiterList<Joystick>& connectedAwaiters()
+        {
+            static AwaiterList<Joystick> awaiters;
+            return awaiters;
+        }
+
+        // The one GLFW joystick callback, it completes the connection awaiters and forwards to the user function
+        void joystickCallback(int jid, int event)
+        {
+            if(event == GLFW_CONNECTED && !connectedAwaiters().empty())
+            {
+                connectedAwaiters().complete(jid);
+            }
+
+            if(joystickFunction)
+            {
+                joystickFunction(jid, static_cast<ConnectionEvent>(event));
+            }
         }
 
-        glfwSetJoystickCallback(nullptr);
+        void installJoystickCallback()
+        {
+            if(!joystickCallbackInstalled)
+            {
+                glfwSetJoystickCallback(joystickCallback);
+                joystickCallbackInstalled = true;
+            }
+        }
+    }
+
+    void resetJoystickCallback()
+    {
+        joystickCallbackInstalled = false;
+    }
+
+    JoystickFunction* setJoystickCallback(JoystickFunction* callback)
+    {
+        joystickFunction = callback == nullptr ? nullptr : *callback;
+        installJoystickCallback();
         return callback;
     }
 
+    EventAwaiter<Joystick> joystickConnected()
+    {
+        installCoroutineScheduler();
+        installJoystickCallback();
+        return EventAwaiter<Joystick>(connectedAwaiters());
+    }
+
     void updateGamepadMappings(const char* string)
     {
         auto success = glfwUpdateGamepadMappings(string);
@@ -52,6 +136,15 @@ namespace glfw
         }
     }
 
+    Result<void> tryUpdateGamepadMappings(const char* string)
+    {
+        if(!glfwUpdateGamepadMappings(string))
+        {
+            return getLastError();
+        }
+        return {};
+    }
+
     Joystick::Joystick() : Joystick(-1) {}
 
     Joystick::Joystick(JoystickType jid) : Joystick(static_cast<int>(jid)) {}
@@ -88,6 +181,27 @@ namespace glfw
         return glfwGetJoystickHats(jid, count);
     }
 
+    std::span<const float> Joystick::getAxes() const
+    {
+        int count = 0;
+        auto axes = glfwGetJoystickAxes(jid, &count);
+        return {axes, static_cast<std::size_t>(count)};
+    }
+
+    std::span<const unsigned char> Joystick::getButtons() const
+    {
+        int count = 0;
+        auto buttons = glfwGetJoystickButtons(jid, &count);
+        return {buttons, static_cast<std::size_t>(count)};
+    }
+
+    std::span<const unsigned char> Joystick::getHats() const
+    {
+        int count = 0;
+        auto hats = glfwGetJoystickHats(jid, &count);
+        return {hats, static_cast<std::size_t>(count)};
+    }
+
     const char* Joystick::getName()
     {
         return glfwGetJoystickName(jid);
@@ -126,6 +240,223 @@ namespace glfw
         {
             throw std::runtime_error(getError());
         }
+
         return state;
     }
+
+    Result<GamepadState> Joystick::tryGetGamepadState()
+    {
+        GamepadState state;
+        if(!glfwGetGamepadState(jid, &state))
+        {
+            // GLFW only reports an error for an invalid id, a missing joystick or mapping just fails quietly
+            return getLastError();
+        }
+        return state;
+    }
+
+    void JoystickSnapshot::capture()
+    {
+        presentMask = 0;
+        gamepadMask = 0;
+
+        for(int jid = 0; jid < JOYSTICK_COUNT; ++jid)
+        {
+            // A present joystick without axes has a null axes array too, so presence is asked for separately
+            bool present = glfwJoystickPresent(jid) == GLFW_TRUE;
+            int axisCount = 0, buttonCount = 0, hatCount = 0;
+            auto nAxes = present ? glfwGetJoystickAxes(jid, &axisCount) : nullptr;
+            auto nButtons = present ? glfwGetJoystickButtons(jid, &buttonCount) : nullptr;
+            auto nHats = present ? glfwGetJoystickHats(jid, &hatCount) : nullptr;
+
+            axisCount = nAxes == nullptr ? 0 : std::min(axisCount, MAX_AXES);
+            buttonCount = nButtons == nullptr ? 0 : std::min(buttonCount, MAX_BUTTONS);
+            hatCount = nHats == nullptr ? 0 : std::min(hatCount, MAX_HATS);
+
+            auto& axisRow = axes[jid];
+            std::fill(std::copy_n(nAxes, axisCount, axisRow.begin()), axisRow.end(), 0.0f);
+            auto& buttonRow = buttons[jid];
+            std::fill(std::copy_n(nButtons, buttonCount, buttonRow.begin()), buttonRow.end(), 0);
+            auto& hatRow = hats[jid];
+            std::fill(std::copy_n(nHats, hatCount, hatRow.begin()), hatRow.end(), 0);
+
+            axisCounts[jid] = static_cast<uint8_t>(axisCount);
+            buttonCounts[jid] = static_cast<uint8_t>(buttonCount);
+            hatCounts[jid] = static_cast<uint8_t>(hatCount);
+
+            gamepadStates[jid] = {};
+            if(present)
+            {
+                presentMask |= 1u << jid;
+                if(glfwGetGamepadState(jid, &gamepadStates[jid]))
+                {
+                    gamepadMask |= 1u << jid;
+                }
+            }
+        }
+    }
+
+    bool JoystickSnapshot::present(Joystick joystick) const
+    {
+        assert(joystick.get() >= 0 && joystick.get() < JOYSTICK_COUNT);
+        return presentMask & (1u << joystick.get());
+    }
+
+    bool JoystickSnapshot::isGamepad(Joystick joystick) const
+    {
+        assert(joystick.get() >= 0 && joystick.get() < JOYSTICK_COUNT);
+        return gamepadMask & (1u << joystick.get());
+    }
+
+    uint16_t JoystickSnapshot::getPresentMask() const
+    {
+        return presentMask;
+    }
+
+    std::span<const float> JoystickSnapshot::getAxes(Joystick joystick) const
+    {
+        assert(joystick.get() >= 0 && joystick.get() < JOYSTICK_COUNT);
+        return std::span(axes[joystick.get()]).first(axisCounts[joystick.get()]);
+    }
+
+    std::span<const unsigned char> JoystickSnapshot::getButtons(Joystick joystick) const
+    {
+        assert(joystick.get() >= 0 && joystick.get() < JOYSTICK_COUNT);
+        return std::span(buttons[joystick.get()]).first(buttonCounts[joystick.get()]);
+    }
+
+    std::span<const unsigned char> JoystickSnapshot::getHats(Joystick joystick) const
+    {
+        assert(joystick.get() >= 0 && joystick.get() < JOYSTICK_COUNT);
+        return std::span(hats[joystick.get()]).first(hatCounts[joystick.get()]);
+    }
+
+    const GamepadState& JoystickSnapshot::getGamepadState(Joystick joystick) const
+    {
+        assert(joystick.get() >= 0 && joystick.get() < JOYSTICK_COUNT);
+        return gamepadStates[joystick.get()];
+    }
+
+    JoystickMonitor::JoystickMonitor(float axisEpsilon) : axisEpsilon(axisEpsilon)
+    {
+        // Enough for a busy frame on every joystick, a larger burst only grows it once
+        events.reserve(JoystickSnapshot::JOYSTICK_COUNT * 16);
+    }
+
+    void JoystickMonitor::setAxisEpsilon(float epsilon)
+    {
+        axisEpsilon = epsilon;
+    }
+
+    float JoystickMonitor::getAxisEpsilon() const
+    {
+        return axisEpsilon;
+    }
+
+    std::span<const JoystickEvent> JoystickMonitor::update()
+    {
+        snapshots[current ^ 1].capture();
+        return diff();
+    }
+
+    std::span<const JoystickEvent> JoystickMonitor::update(const JoystickSnapshot& snapshot)
+    {
+        snapshots[current ^ 1] = snapshot;
+        return diff();
+    }
+
+    const JoystickSnapshot& JoystickMonitor::getSnapshot() const
+    {
+        return snapshots[current];
+    }
+
+    std::span<const JoystickEvent> JoystickMonitor::diff()
+    {
+        const auto& previous = snapshots[current];
+        const auto& next = snapshots[current ^ 1];
+        current ^= 1;
+        events.clear();
+
+        constexpr auto BUTTON_BLOCK = 64;
+        constexpr auto GAMEPAD_BUTTONS = GLFW_GAMEPAD_BUTTON_LAST + 1;
+        constexpr auto GAMEPAD_AXES = GLFW_GAMEPAD_AXIS_LAST + 1;
+        static_assert(JoystickSnapshot::MAX_BUTTONS % BUTTON_BLOCK == 0);
+
+        for(uint8_t jid = 0; jid < JoystickSnapshot::JOYSTICK_COUNT; ++jid)
+        {
+            auto bit = 1u << jid;
+            bool wasPresent = previous.presentMask & bit;
+            bool isPresent = next.presentMask & bit;
+            if(!wasPresent && !isPresent)
+            {
+                continue;
+            }
+
+            if(wasPresent != isPresent)
+            {
+                events.push_back({isPresent ? JoystickEventType::CONNECTED : JoystickEventType::DISCONNECTED, jid});
+                if(!isPresent)
+                {
+                    reportedAxes[jid] = {};
+                    reportedGamepadAxes[jid] = {};
+                    continue;
+                }
+            }
+
+            // Absent rows are all zero, so a new connection reports whatever is already held against that
+            const auto& buttons = next.buttons[jid];
+            const auto& previousButtons = previous.buttons[jid];
+            if(std::memcmp(buttons.data(), previousButtons.data(), buttons.size()) != 0)
+            {
+                for(std::size_t block = 0; block < buttons.size(); block += BUTTON_BLOCK)
+                {
+                    auto mask = changedMask<BUTTON_BLOCK>(&buttons[block], &previousButtons[block]);
+                    forEachBit(mask, block, [&](std::size_t i)
+                    {
+                        events.push_back({buttons[i] ? JoystickEventType::BUTTON_PRESSED :
+                                JoystickEventType::BUTTON_RELEASED, jid, static_cast<uint8_t>(i)});
+                    });
+                }
+            }
+
+            auto hatMask = changedMask<JoystickSnapshot::MAX_HATS>(next.hats[jid].data(), previous.hats[jid].data());
+            forEachBit(hatMask, 0, [&](std::size_t i)
+            {
+                events.push_back({JoystickEventType::HAT_CHANGED, jid, static_cast<uint8_t>(i), next.hats[jid][i]});
+            });
+
+            auto& reported = reportedAxes[jid];
+            auto axisMask = movedMask<JoystickSnapshot::MAX_AXES>(next.axes[jid].data(), reported.data(), axisEpsilon);
+            forEachBit(axisMask, 0, [&](std::size_t i)
+            {
+                reported[i] = next.axes[jid][i];
+                events.push_back({JoystickEventType::AXIS_MOVED, jid, static_cast<uint8_t>(i), 0, reported[i]});
+            });
+
+            if(!(next.gamepadMask & bit) && !(previous.gamepadMask & bit))
+            {
+                continue;
+            }
+
+            const auto& state = next.gamepadStates[jid];
+            auto gamepadButtonMask = changedMask<GAMEPAD_BUTTONS>(state.buttons,
+                    previous.gamepadStates[jid].buttons);
+            forEachBit(gamepadButtonMask, 0, [&](std::size_t i)
+            {
+                events.push_back({state.buttons[i] ? JoystickEventType::GAMEPAD_BUTTON_PRESSED :
+                        JoystickEventType::GAMEPAD_BUTTON_RELEASED, jid, static_cast<uint8_t>(i)});
+            });
+
+            auto& reportedGamepad = reportedGamepadAxes[jid];
+            auto gamepadAxisMask = movedMask<GAMEPAD_AXES>(state.axes, reportedGamepad.data(), axisEpsilon);
+            forEachBit(gamepadAxisMask, 0, [&](std::size_t i)
+            {
+                reportedGamepad[i] = state.axes[i];
+                events.push_back({JoystickEventType::GAMEPAD_AXIS_MOVED, jid, static_cast<uint8_t>(i), 0,
+                        reportedGamepad[i]});
+            });
+        }
+
+        return events;
+    }
 }
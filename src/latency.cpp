@@ -0,0 +1,171 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        // Only the input events are tagged, the remaining histograms stay empty and are left out of the dump
+        constexpr EventType TRACKED_TYPES[] = {
+                EventType::KEY,
+                EventType::CHAR,
+                EventType::MOUSE_BUTTON,
+                EventType::CURSOR_POS,
+                EventType::SCROLL,
+        };
+
+        constexpr const char* TRACKED_NAMES[] = {"key", "char", "mouse_button", "cursor_pos", "scroll"};
+    }
+
+    LatencyTracker::LatencyTracker(Window& window, bool finish) : callbacks(window.callbacks->shared_from_this()), finish(finish)
+    {
+        assert(window.get() != nullptr);
+        window.callbacks->latencyTracker = this;
+    }
+
+    LatencyTracker::~LatencyTracker()
+    {
+        if(auto shared = callbacks.lock(); shared && shared->latencyTracker == this)
+        {
+            shared->latencyTracker = nullptr;
+        }
+    }
+
+    void LatencyTracker::setFinish(bool value)
+    {
+        finish = value;
+    }
+
+    bool LatencyTracker::getFinish() const
+    {
+        return finish;
+    }
+
+    void LatencyTracker::beginFrame()
+    {
+        frame = presented + 1;
+    }
+
+    uint64_t LatencyTracker::getFrame() const
+    {
+        return frame;
+    }
+
+    uint64_t LatencyTracker::getPresentedCount() const
+    {
+        return presented;
+    }
+
+    uint64_t LatencyTracker::getDroppedCount() const
+    {
+        return dropped;
+    }
+
+    const LatencyHistogram& LatencyTracker::getHistogram(EventType type) const
+    {
+        return histograms[static_cast<std::size_t>(type)];
+    }
+
+    std::string LatencyTracker::toJson() const
+    {
+        std::string out = "{\n  \"frames\": " + std::to_string(presented) + ",\n  \"dropped\": " + std::to_string(dropped);
+        for(std::size_t i = 0; i < std::size(TRACKED_TYPES); ++i)
+        {
+            const auto& histogram = getHistogram(TRACKED_TYPES[i]);
+            char row[256];
+            std::snprintf(row, sizeof(row), ",\n  \"%s\": {\"count\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %llu, "
+                    "\"p95_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}", TRACKED_NAMES[i],
+                    static_cast<unsigned long long>(histogram.getCount()), histogram.getMean(),
+                    static_cast<unsigned long long>(histogram.getPercentile(50.0)),
+                    static_cast<unsigned long long>(histogram.getPercentile(95.0)),
+                    static_cast<unsigned long long>(histogram.getPercentile(99.0)),
+                    static_cast<unsigned long long>(histogram.getMax()));
+            out += row;
+        }
+        out += "\n}\n";
+        return out;
+    }
+
+    void LatencyTracker::reset()
+    {
+        for(auto& histogram : histograms)
+        {
+            histogram.reset();
+        }
+        dropped = 0;
+        pendingCount = 0;
+    }
+
+    void LatencyTracker::tag(EventType type)
+    {
+        if(pendingCount == pending.size())
+        {
+            ++dropped;
+            return;
+        }
+        pending[pendingCount++] = {type, frame, glfwGetTimerValue()};
+    }
+
+    void LatencyTracker::present()
+    {
+        if(finish)
+        {
+            if(glFinish == nullptr)
+            {
+                glFinish = glfwGetProcAddress("glFinish");
+            }
+            if(glFinish != nullptr)
+            {
+                glFinish();
+            }
+        }
+
+        static const auto frequency = static_cast<double>(glfwGetTimerFrequency());
+        auto now = glfwGetTimerValue();
+        std::size_t kept = 0;
+        for(std::size_t i = 0; i < pendingCount; ++i)
+        {
+            // Tagged after beginFrame, the event did not make it into the frame being presented
+            if(pending[i].frame > presented)
+            {
+                pending[kept++] = pending[i];
+                continue;
+            }
+            auto nanoseconds = static_cast<double>(now - pending[i].time) * 1e9 / frequency;
+            histograms[static_cast<std::size_t>(pending[i].type)].record(static_cast<uint64_t>(nanoseconds));
+        }
+        pendingCount = kept;
+        frame = std::max(frame, ++presented);
+    }
+}
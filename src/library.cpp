@@ -20,15 +20,72 @@
 
 module;
 
+#include <algorithm>
 #include <string>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 #include <GLFW/glfw3.h>
 
 module glfw;
 
 namespace glfw
 {
-    void initHint(int hint, int value) // TODO: type and enums
+    namespace
+    {
+        std::vector<std::pair<EventHook, void*>> eventHooks;
+
+        void runEventHooks()
+        {
+            // Indexed so a hook may add another hook while running
+            for(std::size_t i = 0; i < eventHooks.size(); ++i)
+            {
+                auto [hook, user] = eventHooks[i];
+                hook(user);
+            }
+        }
+    }
+
+    void addEventHook(EventHook hook, void* user)
+    {
+        eventHooks.emplace_back(hook, user);
+    }
+
+    void removeEventHook(EventHook hook, void* user)
+    {
+        std::erase(eventHooks, std::pair{hook, user});
+    }
+
+    namespace
+    {
+        bool headless = false;
+    }
+
+    void applyLibraryWindowHints()
+    {
+        invalidateAppliedHints();
+        if(headless)
+        {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        }
+    }
+
+    void initHint(InitHint hint, bool value)
+    {
+        initHint(static_cast<int>(hint), value ? GLFW_TRUE : GLFW_FALSE);
+    }
+
+    void initHint(InitHint hint, InitValue value)
+    {
+        initHint(static_cast<int>(hint), static_cast<int>(value));
+    }
+
+    void initHint(InitHint hint, Platform value)
+    {
+        initHint(static_cast<int>(hint), static_cast<int>(value));
+    }
+
+    void initHint(int hint, int value)
     {
         glfwInitHint(hint, value);
     }
@@ -38,8 +95,6 @@ namespace glfw
         glfwInitAllocator(allocator);
     }
 
-    // inline void glfwInitVulkanLoader(PFN_vkGetInstanceProcAddr loader) // TODO
-
     constexpr Version getCompileTimeVersion()
     {
         return {GLFW_VERSION_MAJOR, GLFW_VERSION_MINOR, GLFW_VERSION_REVISION};
@@ -61,7 +116,14 @@ namespace glfw
     {
         const char* description;
         glfwGetError(&description);
-        return description;
+        return description == nullptr ? std::string() : description;
+    }
+
+    Error getLastError()
+    {
+        const char* description;
+        auto code = glfwGetError(&description);
+        return {static_cast<ErrorCode>(code), description == nullptr ? "" : description};
     }
 
     ErrorFun setErrorCallback(ErrorFun fun)
@@ -76,24 +138,33 @@ namespace glfw
         return glfwGetPlatform();
     }
 
-    bool platformSupported(int platform) // TODO: type checked method
+    bool platformSupported(Platform platform)
+    {
+        return platformSupported(static_cast<int>(platform));
+    }
+
+    bool platformSupported(int platform)
     {
         return glfwPlatformSupported(platform) == GLFW_TRUE;
     }
 
     void pollEvents()
     {
+        ScopedTimer timer(Metric::POLL_EVENTS);
         glfwPollEvents();
+        runEventHooks();
     }
 
     void waitEvents()
     {
         glfwWaitEvents();
+        runEventHooks();
     }
 
     void waitEventsTimeout(double timeout)
     {
         glfwWaitEventsTimeout(timeout);
+        runEventHooks();
     }
 
     void postEmptyEvent()
@@ -141,11 +212,17 @@ namespace glfw
         glfwSwapInterval(interval);
     }
 
-    [[nodiscard]] inline bool extensionSupported(const char* extension);
+    bool extensionSupported(const char* extension)
+    {
+        auto cache = getProcCache();
+        return cache == nullptr ? glfwExtensionSupported(extension) == GLFW_TRUE : cache->extensionSupported(extension);
+    }
 
     glProc getProcAddress(const char* procname)
     {
-        return glfwGetProcAddress(procname);
+        // Without a current context GLFW reports the error and returns null, nothing worth caching
+        auto cache = getProcCache();
+        return cache == nullptr ? glfwGetProcAddress(procname) : cache->getProcAddress(procname);
     }
 
     bool vulkanSupported()
@@ -158,9 +235,29 @@ namespace glfw
         return glfwGetRequiredInstanceExtensions(count);
     }
 
-    // inline GLFWvkproc getInstanceProcAddress (VkInstance instance, const char *procname); // TODO:
-    // bool getPhysicalDevicePresentationSupport(VkInstance instance, VkPhysicalDevice device, uint32_t queuefamily);
-    // VkResult createWindowSurface(VkInstance instance, GLFWwindow *window, const VkAllocationCallbacks *allocator, VkSurfaceKHR *surface); // TODO: should this be part of Window instead?
+    namespace
+    {
+        bool initialize(const LibraryOptions& options)
+        {
+            initHint(InitHint::PLATFORM, options.headless ? Platform::PLATFORM_NULL : options.platform);
+            initHint(InitHint::JOYSTICK_HAT_BUTTONS, options.joystickHatButtons);
+            initHint(InitHint::ANGLE_PLATFORM_TYPE, options.anglePlatformType);
+            initHint(InitHint::COCOA_CHDIR_RESOURCES, options.cocoaChdirResources);
+            initHint(InitHint::COCOA_MENUBAR, options.cocoaMenubar);
+            initHint(InitHint::X11_XCB_VULKAN_SURFACE, options.x11XcbVulkanSurface);
+            initHint(InitHint::WAYLAND_LIBDECOR, options.waylandLibdecor);
+            initAllocator(options.allocator);
+
+            if(!glfwInit())
+            {
+                return false;
+            }
+
+            headless = options.headless;
+            applyLibraryWindowHints();
+            return true;
+        }
+    }
 
     Library::Library()
     {
@@ -170,8 +267,52 @@ namespace glfw
         }
     }
 
+    Library::Library(const LibraryOptions& options)
+    {
+        if(!initialize(options))
+        {
+            throw std::runtime_error(getError());
+        }
+    }
+
+    Library::Library(Initialized) {}
+
+    Library::Library(Library&& other) noexcept : owner(std::exchange(other.owner, false)) {}
+
     Library::~Library()
     {
+        if(!owner)
+        {
+            return;
+        }
+
         glfwTerminate();
+        headless = false;
+        resetMonitorRegistry();
+        resetJoystickCallback();
+        resetProcCaches();
+        invalidateAppliedHints();
+        resetTrackedWindowHints();
+#ifdef GLFW_CPP_VULKAN
+        resetVulkanCache();
+#endif
+    }
+
+    Result<Library> Library::tryCreate()
+    {
+        if(!glfwInit())
+        {
+            return getLastError();
+        }
+        return Library(Initialized());
+    }
+
+    Result<Library> Library::tryCreate(const LibraryOptions& options)
+    {
+        if(!initialize(options))
+        {
+            return getLastError();
+        }
+        return Library(Initialized());
     }
 }
@@ -20,6 +20,11 @@
 
 module;
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
 #include <vector>
 #include <string>
 #include <glfw/glfw3.h>
@@ -28,6 +33,50 @@ module glfw;
 
 namespace glfw
 {
+    namespace
+    {
+        MonitorFunction monitorFunction;
+        std::shared_ptr<const MonitorSnapshot> snapshot;
+        uint64_t version = 1;
+        bool dirty = true;
+        bool installed = false;
+
+        // The one GLFW monitor callback, it keeps the registry current and forwards to the user function
+        void monitorCallback(GLFWmonitor* monitor, int event)
+        {
+            if(!dirty)
+            {
+                dirty = true;
+                ++version;
+            }
+
+            if(monitorFunction)
+            {
+                monitorFunction(monitor, static_cast<ConnectionEvent>(event));
+            }
+        }
+
+        void installMonitorCallback()
+        {
+            if(!installed)
+            {
+                glfwSetMonitorCallback(monitorCallback);
+                installed = true;
+            }
+        }
+    }
+
+    void resetMonitorRegistry()
+    {
+        snapshot.reset();
+        if(!dirty)
+        {
+            dirty = true;
+            ++version;
+        }
+        installed = false; // Termination clears the GLFW callbacks
+    }
+
     std::vector<Monitor> getMonitors()
     {
         int count;
@@ -51,18 +100,9 @@ namespace glfw
 
     MonitorFunction* setMonitorCallback(MonitorFunction* callback)
     {
-        static MonitorFunction monitorCallback = *callback;
-        if(callback == nullptr)
-        {
-            glfwSetMonitorCallback(nullptr);
-        }
-        else
-        {
-            glfwSetMonitorCallback([](GLFWmonitor* monitor, int event)
-            {
-                monitorCallback(monitor, static_cast<ConnectionEvent>(event));
-            });
-        }
+        // The GLFW callback stays installed without a user function so the registry still hears about changes
+        monitorFunction = callback == nullptr ? nullptr : *callback;
+        installMonitorCallback();
         return callback;
     }
 
@@ -151,4 +191,109 @@ namespace glfw
     {
         glfwSetGammaRamp(ptr, ramp);
     }
+
+    uint64_t MonitorSnapshot::getVersion() const
+    {
+        return version;
+    }
+
+    std::span<const MonitorInfo> MonitorSnapshot::getMonitors() const
+    {
+        return monitors;
+    }
+
+    const MonitorInfo* MonitorSnapshot::getPrimary() const
+    {
+        return monitors.empty() ? nullptr : &monitors[primary];
+    }
+
+    const MonitorInfo* MonitorSnapshot::find(Monitor monitor) const
+    {
+        auto it = std::find_if(monitors.begin(), monitors.end(), [&](const MonitorInfo& info)
+        {
+            return info.monitor.get() == monitor.get();
+        });
+        return it == monitors.end() ? nullptr : &*it;
+    }
+
+    std::shared_ptr<const MonitorSnapshot> MonitorRegistry::getSnapshot()
+    {
+        installMonitorCallback();
+        if(dirty || snapshot == nullptr)
+        {
+            snapshot = build(version);
+            dirty = false;
+        }
+        return snapshot;
+    }
+
+    uint64_t MonitorRegistry::getVersion()
+    {
+        return version;
+    }
+
+    void MonitorRegistry::invalidate()
+    {
+        if(!dirty)
+        {
+            dirty = true;
+            ++version;
+        }
+    }
+
+    std::shared_ptr<const MonitorSnapshot> MonitorRegistry::build(uint64_t snapshotVersion)
+    {
+        auto result = std::make_shared<MonitorSnapshot>();
+        result->version = snapshotVersion;
+
+        int count;
+        auto nMonitors = glfwGetMonitors(&count);
+        auto nPrimary = glfwGetPrimaryMonitor();
+
+        // Size the shared storage up front so the spans and names handed out below never move
+        std::vector<std::pair<const GLFWvidmode*, int>> nModes(count);
+        std::size_t modeCount = 0;
+        std::size_t nameSize = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            nModes[i].first = glfwGetVideoModes(nMonitors[i], &nModes[i].second);
+            modeCount += nModes[i].second;
+            auto name = glfwGetMonitorName(nMonitors[i]);
+            nameSize += name == nullptr ? 0 : std::char_traits<char>::length(name);
+        }
+        result->videoModes.reserve(modeCount);
+        result->names.reserve(nameSize);
+        result->monitors.reserve(count);
+
+        for(int i = 0; i < count; ++i)
+        {
+            Monitor monitor = nMonitors[i];
+
+            auto modesBegin = result->videoModes.size();
+            result->videoModes.insert(result->videoModes.end(), nModes[i].first, nModes[i].first + nModes[i].second);
+
+            auto nameBegin = result->names.size();
+            auto name = glfwGetMonitorName(monitor);
+            result->names.append(name == nullptr ? "" : name);
+
+            auto mode = glfwGetVideoMode(monitor);
+            result->monitors.push_back({
+                    monitor,
+                    monitor.getPos(),
+                    monitor.getWorkarea(),
+                    monitor.getPhysicalSize(),
+                    monitor.getContentScale(),
+                    mode == nullptr ? VideoMode{} : *mode,
+                    std::span<const VideoMode>(result->videoModes).subspan(modesBegin, nModes[i].second),
+                    std::string_view(result->names).substr(nameBegin)
+            });
+
+            if(monitor.get() == nPrimary)
+            {
+                result->primary = i;
+            }
+        }
+
+        return result;
+    }
 }
@@ -0,0 +1,631 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+module;
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        // Trace layout: the 8 byte magic, the timer frequency as a raw uint64_t, then records of a tag byte, a window
+        //  index byte, the varint tick delta since the previous record and a payload that depends on the tag.
+        constexpr char MAGIC[8] = {'G', 'L', 'F', 'W', 'R', 'E', 'C', 1};
+        constexpr uint8_t TAG_DROP = 0x10;
+        constexpr uint8_t TAG_JOYSTICK = 0x11;
+        constexpr uint8_t TAG_INTEGRAL = 0x80; // Position payload is a zigzag varint delta instead of raw doubles
+        constexpr std::size_t SUBMIT_SIZE = 64 * 1024;
+
+        void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+        {
+            while(value >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void writeSigned(std::vector<uint8_t>& out, int64_t value)
+        {
+            writeVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        template<typename T>
+        void writeRaw(std::vector<uint8_t>& out, const T& value)
+        {
+            auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        bool isIntegral(double value)
+        {
+            return std::trunc(value) == value && std::abs(value) < 0x1p52;
+        }
+
+        // Positions are nearly always whole pixels, those only need a couple of bytes as a delta from the last one
+        bool isIntegral(Position<double> pos, Position<double> previous)
+        {
+            return isIntegral(pos.x) && isIntegral(pos.y) && isIntegral(previous.x) && isIntegral(previous.y);
+        }
+
+        void writePosition(std::vector<uint8_t>& out, bool integral, Position<double> pos, Position<double> previous)
+        {
+            if(integral)
+            {
+                writeSigned(out, static_cast<int64_t>(pos.x - previous.x));
+                writeSigned(out, static_cast<int64_t>(pos.y - previous.y));
+            }
+            else
+            {
+                writeRaw(out, pos.x);
+                writeRaw(out, pos.y);
+            }
+        }
+
+        class Reader
+        {
+        public:
+            Reader(const std::vector<uint8_t>& data, std::size_t& offset) : data(data), offset(offset) {}
+
+            uint8_t byte()
+            {
+                require(1);
+                return data[offset++];
+            }
+
+            uint64_t varint()
+            {
+                uint64_t value = 0;
+                for(int shift = 0; shift < 64; shift += 7)
+                {
+                    auto b = byte();
+                    value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                    if(!(b & 0x80))
+                    {
+                        break;
+                    }
+                }
+                return value;
+            }
+
+            int64_t signedVarint()
+            {
+                auto value = varint();
+                return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+
+            template<typename T>
+            T raw()
+            {
+                require(sizeof(T));
+                T value;
+                std::memcpy(&value, &data[offset], sizeof(T));
+                offset += sizeof(T);
+                return value;
+            }
+
+            Position<double> position(bool integral, Position<double> previous)
+            {
+                if(integral)
+                {
+                    auto dx = static_cast<double>(signedVarint());
+                    auto dy = static_cast<double>(signedVarint());
+                    return {previous.x + dx, previous.y + dy};
+                }
+                auto x = raw<double>();
+                auto y = raw<double>();
+                return {x, y};
+            }
+
+        private:
+            void require(std::size_t count)
+            {
+                if(data.size() - offset < count)
+                {
+                    throw std::runtime_error("Input trace is truncated");
+                }
+            }
+
+            const std::vector<uint8_t>& data;
+            std::size_t& offset;
+        };
+
+        // GLFW has no getter for callbacks, but setting one returns the previous so swap it out and straight back
+        template<typename Fun>
+        Fun installedCallback(GLFWwindow* window, Fun (*set)(GLFWwindow*, Fun))
+        {
+            auto fun = set(window, nullptr);
+            set(window, fun);
+            return fun;
+        }
+    }
+
+    InputRecorder::InputRecorder(const char* path) : lastTime(glfwGetTimerValue()),
+            file(path, std::ios::binary | std::ios::trunc)
+    {
+        if(!file)
+        {
+            throw std::runtime_error(std::string("Unable to open input trace ") + path);
+        }
+
+        buffer.reserve(SUBMIT_SIZE * 2);
+        buffer.insert(buffer.end(), std::begin(MAGIC), std::end(MAGIC));
+        writeRaw(buffer, glfwGetTimerFrequency());
+
+        writer = std::thread(&InputRecorder::writeLoop, this);
+    }
+
+    InputRecorder::~InputRecorder()
+    {
+        for(const auto& weak : windowCallbacks)
+        {
+            if(auto callbacks = weak.lock(); callbacks && callbacks->recorder == this)
+            {
+                callbacks->recorder = nullptr;
+            }
+        }
+
+        flush();
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        condition.notify_one();
+        writer.join();
+    }
+
+    void InputRecorder::attach(Window& window)
+    {
+        assert(window.get() != nullptr);
+        windows.push_back(window.get());
+        windowCallbacks.push_back(window.callbacks->shared_from_this());
+        lastCursorPos.push_back({0, 0});
+        window.callbacks->recorder = this;
+    }
+
+    void InputRecorder::detach(Window& window)
+    {
+        assert(window.get() != nullptr);
+        auto it = std::ranges::find(windows, window.get());
+        if(it != windows.end())
+        {
+            *it = nullptr; // Keep the slot so later windows keep their index
+            window.callbacks->recorder = nullptr;
+        }
+    }
+
+    void InputRecorder::recordJoystick(Joystick joystick)
+    {
+        auto jid = joystick.get();
+        assert(jid >= 0 && jid <= GLFW_JOYSTICK_LAST);
+
+        JoystickRecord current{glfwJoystickPresent(jid) == GLFW_TRUE, {}};
+        if(current.present && !glfwGetGamepadState(jid, &current.state))
+        {
+            current.state = {};
+        }
+
+        auto& last = joysticks[jid];
+        if(current.present == last.present
+                && std::ranges::equal(current.state.buttons, last.state.buttons)
+                && std::ranges::equal(current.state.axes, last.state.axes))
+        {
+            return;
+        }
+        last = current;
+
+        beginRecord(TAG_JOYSTICK, nullptr);
+        buffer.push_back(static_cast<uint8_t>(jid));
+        buffer.push_back(current.present ? 1 : 0);
+        buffer.insert(buffer.end(), std::begin(current.state.buttons), std::end(current.state.buttons));
+        for(auto axis : current.state.axes)
+        {
+            writeRaw(buffer, axis);
+        }
+        submitIfFull();
+    }
+
+    void InputRecorder::flush()
+    {
+        {
+            std::lock_guard lock(mutex);
+            if(pending.empty())
+            {
+                pending.swap(buffer); // Swapping keeps both buffers' capacity so steady state recording never allocates
+            }
+            else
+            {
+                pending.insert(pending.end(), buffer.begin(), buffer.end());
+                buffer.clear();
+            }
+        }
+        condition.notify_one();
+    }
+
+    void InputRecorder::record(GLFWwindow* window, const Event& event)
+    {
+        switch(event.type)
+        {
+            case EventType::KEY:
+                beginRecord(static_cast<uint8_t>(event.type), window);
+                writeSigned(buffer, static_cast<int>(event.key.key));
+                writeSigned(buffer, event.key.scancode);
+                buffer.push_back(static_cast<uint8_t>(event.key.action));
+                buffer.push_back(static_cast<uint8_t>(event.key.mods));
+                break;
+
+            case EventType::CHAR:
+                beginRecord(static_cast<uint8_t>(event.type), window);
+                writeVarint(buffer, event.codepoint);
+                break;
+
+            case EventType::MOUSE_BUTTON:
+                beginRecord(static_cast<uint8_t>(event.type), window);
+                buffer.push_back(static_cast<uint8_t>(event.mouseButton.button));
+                buffer.push_back(static_cast<uint8_t>(event.mouseButton.action));
+                buffer.push_back(static_cast<uint8_t>(event.mouseButton.mods));
+                break;
+
+            case EventType::CURSOR_POS:
+            {
+                auto index = std::ranges::find(windows, window) - windows.begin();
+                auto& previous = lastCursorPos[index];
+                auto integral = isIntegral(event.cursorPos, previous);
+                beginRecord(static_cast<uint8_t>(event.type) | (integral ? TAG_INTEGRAL : 0), window);
+                writePosition(buffer, integral, event.cursorPos, previous);
+                previous = event.cursorPos;
+                break;
+            }
+
+            case EventType::SCROLL:
+            {
+                auto integral = isIntegral(event.scroll, {0, 0});
+                beginRecord(static_cast<uint8_t>(event.type) | (integral ? TAG_INTEGRAL : 0), window);
+                writePosition(buffer, integral, event.scroll, {0, 0});
+                break;
+            }
+
+            case EventType::WINDOW_SIZE:
+            case EventType::FRAMEBUFFER_SIZE:
+                beginRecord(static_cast<uint8_t>(event.type), window);
+                writeVarint(buffer, event.size.width);
+                writeVarint(buffer, event.size.height);
+                break;
+
+            case EventType::FOCUS:
+                beginRecord(static_cast<uint8_t>(event.type), window);
+                buffer.push_back(event.focused ? 1 : 0);
+                break;
+
+            default:
+                return;
+        }
+        submitIfFull();
+    }
+
+    void InputRecorder::recordDrop(GLFWwindow* window, int count, const char* paths[])
+    {
+        beginRecord(TAG_DROP, window);
+        writeVarint(buffer, count);
+        for(int i = 0; i < count; ++i)
+        {
+            auto length = std::strlen(paths[i]);
+            writeVarint(buffer, length);
+            buffer.insert(buffer.end(), paths[i], paths[i] + length);
+        }
+        submitIfFull();
+    }
+
+    void InputRecorder::beginRecord(uint8_t tag, GLFWwindow* window)
+    {
+        auto index = window ? std::ranges::find(windows, window) - windows.begin() : 0;
+        auto time = glfwGetTimerValue();
+
+        buffer.push_back(tag);
+        buffer.push_back(static_cast<uint8_t>(index));
+        writeVarint(buffer, time - lastTime);
+        lastTime = time;
+    }
+
+    void InputRecorder::submitIfFull()
+    {
+        if(buffer.size() >= SUBMIT_SIZE)
+        {
+            flush();
+        }
+    }
+
+    void InputRecorder::writeLoop()
+    {
+        std::vector<uint8_t> local;
+        std::unique_lock lock(mutex);
+        while(true)
+        {
+            condition.wait(lock, [this] { return stopping || !pending.empty(); });
+            if(pending.empty())
+            {
+                break;
+            }
+
+            local.swap(pending);
+            lock.unlock();
+            file.write(reinterpret_cast<const char*>(local.data()), static_cast<std::streamsize>(local.size()));
+            local.clear();
+            lock.lock();
+        }
+        file.flush();
+    }
+
+    InputPlayer::InputPlayer(const char* path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if(!file)
+        {
+            throw std::runtime_error(std::string("Unable to open input trace ") + path);
+        }
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        if(data.size() < sizeof(MAGIC) + sizeof(uint64_t) || !std::equal(std::begin(MAGIC), std::end(MAGIC), data.begin()))
+        {
+            throw std::runtime_error(std::string("Not an input trace ") + path);
+        }
+
+        offset = sizeof(MAGIC);
+        frequency = Reader(data, offset).raw<uint64_t>();
+        begin = offset;
+    }
+
+    void InputPlayer::attach(Window& window)
+    {
+        assert(window.get() != nullptr);
+        windows.push_back(window.get());
+        lastCursorPos.push_back({0, 0});
+    }
+
+    void InputPlayer::setSpeed(double speed)
+    {
+        this->speed = speed;
+    }
+
+    void InputPlayer::start()
+    {
+        offset = begin;
+        traceTime = 0;
+        startTime = glfwGetTimerValue();
+        std::ranges::fill(lastCursorPos, Position<double>{0, 0});
+        present = {};
+        states = {};
+    }
+
+    bool InputPlayer::update()
+    {
+        auto due = std::numeric_limits<uint64_t>::max();
+        if(speed > 0)
+        {
+            auto elapsed = static_cast<double>(glfwGetTimerValue() - startTime) / static_cast<double>(glfwGetTimerFrequency());
+            due = static_cast<uint64_t>(elapsed * speed * static_cast<double>(frequency));
+        }
+
+        Reader reader(data, offset);
+        while(offset < data.size())
+        {
+            auto recordStart = offset;
+            auto tag = reader.byte();
+            auto index = reader.byte();
+            auto delta = reader.varint();
+            if(traceTime + delta > due)
+            {
+                offset = recordStart;
+                return true;
+            }
+
+            traceTime += delta;
+            inject(tag, index < windows.size() ? windows[index] : nullptr);
+        }
+        return false;
+    }
+
+    bool InputPlayer::finished() const
+    {
+        return offset >= data.size();
+    }
+
+    bool InputPlayer::joystickPresent(Joystick joystick) const
+    {
+        return present[joystick.get()];
+    }
+
+    const GamepadState& InputPlayer::getGamepadState(Joystick joystick) const
+    {
+        return states[joystick.get()];
+    }
+
+    void InputPlayer::inject(uint8_t tag, GLFWwindow* window)
+    {
+        // Payloads are always read in full so records for windows that were not attached are skipped cleanly
+        Reader reader(data, offset);
+        auto integral = (tag & TAG_INTEGRAL) != 0;
+        switch(tag & ~TAG_INTEGRAL)
+        {
+            case static_cast<uint8_t>(EventType::KEY):
+            {
+                auto key = static_cast<int>(reader.signedVarint());
+                auto scancode = static_cast<int>(reader.signedVarint());
+                int action = reader.byte();
+                int mods = reader.byte();
+                if(auto fun = window ? installedCallback(window, glfwSetKeyCallback) : nullptr)
+                {
+                    fun(window, key, scancode, action, mods);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::CHAR):
+            {
+                auto codepoint = static_cast<unsigned int>(reader.varint());
+                if(auto fun = window ? installedCallback(window, glfwSetCharCallback) : nullptr)
+                {
+                    fun(window, codepoint);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::MOUSE_BUTTON):
+            {
+                int button = reader.byte();
+                int action = reader.byte();
+                int mods = reader.byte();
+                if(auto fun = window ? installedCallback(window, glfwSetMouseButtonCallback) : nullptr)
+                {
+                    fun(window, button, action, mods);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::CURSOR_POS):
+            {
+                auto index = std::ranges::find(windows, window) - windows.begin();
+                Position<double> pos{};
+                if(window)
+                {
+                    pos = reader.position(integral, lastCursorPos[index]);
+                    lastCursorPos[index] = pos;
+                }
+                else
+                {
+                    pos = reader.position(integral, {0, 0});
+                }
+                if(auto fun = window ? installedCallback(window, glfwSetCursorPosCallback) : nullptr)
+                {
+                    fun(window, pos.x, pos.y);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::SCROLL):
+            {
+                auto scroll = reader.position(integral, {0, 0});
+                if(auto fun = window ? installedCallback(window, glfwSetScrollCallback) : nullptr)
+                {
+                    fun(window, scroll.x, scroll.y);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::WINDOW_SIZE):
+            {
+                auto width = static_cast<int>(reader.varint());
+                auto height = static_cast<int>(reader.varint());
+                if(auto fun = window ? installedCallback(window, glfwSetWindowSizeCallback) : nullptr)
+                {
+                    fun(window, width, height);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::FRAMEBUFFER_SIZE):
+            {
+                auto width = static_cast<int>(reader.varint());
+                auto height = static_cast<int>(reader.varint());
+                if(auto fun = window ? installedCallback(window, glfwSetFramebufferSizeCallback) : nullptr)
+                {
+                    fun(window, width, height);
+                }
+                break;
+            }
+
+            case static_cast<uint8_t>(EventType::FOCUS):
+            {
+                int focused = reader.byte();
+                if(auto fun = window ? installedCallback(window, glfwSetWindowFocusCallback) : nullptr)
+                {
+                    fun(window, focused);
+                }
+                break;
+            }
+
+            case TAG_DROP:
+            {
+                auto count = reader.varint();
+                std::vector<std::string> paths(count);
+                for(auto& path : paths)
+                {
+                    auto length = reader.varint();
+                    path.reserve(length);
+                    for(uint64_t i = 0; i < length; ++i)
+                    {
+                        path.push_back(static_cast<char>(reader.byte()));
+                    }
+                }
+
+                std::vector<const char*> pointers;
+                pointers.reserve(count);
+                for(const auto& path : paths)
+                {
+                    pointers.push_back(path.c_str());
+                }
+                if(auto fun = window ? installedCallback(window, glfwSetDropCallback) : nullptr)
+                {
+                    fun(window, static_cast<int>(count), pointers.data());
+                }
+                break;
+            }
+
+            case TAG_JOYSTICK:
+            {
+                auto jid = reader.byte();
+                if(jid > GLFW_JOYSTICK_LAST)
+                {
+                    throw std::runtime_error("Input trace is corrupt");
+                }
+                present[jid] = reader.byte() != 0;
+                for(auto& button : states[jid].buttons)
+                {
+                    button = reader.byte();
+                }
+                for(auto& axis : states[jid].axes)
+                {
+                    axis = reader.raw<float>();
+                }
+                break;
+            }
+
+            default:
+                throw std::runtime_error("Input trace is corrupt");
+        }
+    }
+}
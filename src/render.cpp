@@ -0,0 +1,141 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        uint64_t packSize(Size size)
+        {
+            return static_cast<uint64_t>(static_cast<uint32_t>(size.width)) << 32 | static_cast<uint32_t>(size.height);
+        }
+
+        Size unpackSize(uint64_t packed)
+        {
+            return {static_cast<int>(packed >> 32), static_cast<int>(packed & 0xFFFFFFFF)};
+        }
+    }
+
+    RenderThread::RenderThread(Window& window, RenderFunction render, int swapInterval) : window(window),
+            render(std::move(render)), framebufferSize(packSize(window.getFramebufferSize()))
+    {
+        assert(window.get() != nullptr);
+        assert(window.callbacks->renderThread == nullptr);
+
+        // A context can only be current on one thread, hand it over before the render thread takes it
+        if(glfwGetCurrentContext() == window.get())
+        {
+            glfwMakeContextCurrent(nullptr);
+        }
+
+        // The framebuffer size reaches the render thread through Window::updateProperties
+        window.callbacks->renderThread = this;
+
+        thread = std::thread(&RenderThread::run, this, swapInterval);
+    }
+
+    RenderThread::~RenderThread()
+    {
+        stop();
+        window.callbacks->renderThread = nullptr;
+    }
+
+    void RenderThread::stop()
+    {
+        stopping.store(true, std::memory_order_release);
+        if(thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    bool RenderThread::isRunning() const
+    {
+        return running.load(std::memory_order_acquire);
+    }
+
+    uint64_t RenderThread::getFrameCount() const
+    {
+        return frames.load(std::memory_order_relaxed);
+    }
+
+    void RenderThread::rethrow()
+    {
+        // Only written by the render thread before it stops running
+        if(!isRunning() && failure)
+        {
+            std::rethrow_exception(std::exchange(failure, nullptr));
+        }
+    }
+
+    void RenderThread::resize(Size size)
+    {
+        framebufferSize.store(packSize(size), std::memory_order_relaxed);
+        resized.store(true, std::memory_order_release);
+    }
+
+    void RenderThread::run(int swapInterval)
+    {
+        glfwMakeContextCurrent(window.get());
+        if(swapInterval >= 0)
+        {
+            glfwSwapInterval(swapInterval);
+        }
+
+        try
+        {
+            while(!stopping.load(std::memory_order_acquire))
+            {
+                auto wasResized = resized.exchange(false, std::memory_order_acquire);
+                RenderFrame frame{frames.load(std::memory_order_relaxed),
+                        unpackSize(framebufferSize.load(std::memory_order_relaxed)), wasResized};
+                render(window, frame);
+
+                {
+                    // Straight to GLFW, Window::swapBuffers also feeds main thread only state such as latency tracking
+                    ScopedTimer timer(Metric::SWAP_BUFFERS);
+                    glfwSwapBuffers(window.get());
+                }
+                frames.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        catch(...)
+        {
+            failure = std::current_exception();
+        }
+
+        // Released before the thread ends so the main thread can take the context back once joined
+        glfwMakeContextCurrent(nullptr);
+        running.store(false, std::memory_order_release);
+    }
+}
@@ -0,0 +1,172 @@
+// zLib License
+//
+// Copyright (c) 2024 Josh "ShadowLordAlpha"
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+module;
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+module glfw;
+
+namespace glfw
+{
+    namespace
+    {
+        std::span<const char* const> requiredExtensions;
+    }
+
+    void resetVulkanCache()
+    {
+        requiredExtensions = {};
+    }
+
+    void initVulkanLoader(PFN_vkGetInstanceProcAddr loader)
+    {
+        glfwInitVulkanLoader(loader);
+    }
+
+    std::span<const char* const> getRequiredInstanceExtensions()
+    {
+        if(requiredExtensions.empty())
+        {
+            // Null is not cached, Vulkan may still become available on a later call after an error was fixed
+            uint32_t count = 0;
+            auto extensions = glfwGetRequiredInstanceExtensions(&count);
+            if(extensions != nullptr)
+            {
+                requiredExtensions = {extensions, count};
+            }
+        }
+        return requiredExtensions;
+    }
+
+    VulkanProc getInstanceProcAddress(VkInstance instance, const char* procname)
+    {
+        return glfwGetInstanceProcAddress(instance, procname);
+    }
+
+    bool getPhysicalDevicePresentationSupport(VkInstance instance, VkPhysicalDevice device, uint32_t queueFamily)
+    {
+        return glfwGetPhysicalDevicePresentationSupport(instance, device, queueFamily) == GLFW_TRUE;
+    }
+
+    namespace
+    {
+        VkSurfaceKHR createSurface(VkInstance instance, const Window& window, const VkAllocationCallbacks* allocator)
+        {
+            assert(window.get() != nullptr);
+            VkSurfaceKHR surface = VK_NULL_HANDLE;
+            if(glfwCreateWindowSurface(instance, window.get(), allocator, &surface) != VK_SUCCESS)
+            {
+                return VK_NULL_HANDLE;
+            }
+            return surface;
+        }
+    }
+
+    Surface::Surface(Created, VkInstance instance, const Window& window, const VkAllocationCallbacks* allocator,
+                     VkSurfaceKHR surface) : instance(instance), surface(surface), allocator(allocator),
+            window(window.callbacks->shared_from_this())
+    {
+        destroy = reinterpret_cast<PFN_vkDestroySurfaceKHR>(getInstanceProcAddress(instance, "vkDestroySurfaceKHR"));
+    }
+
+    Surface::Surface(VkInstance instance, const Window& window, const VkAllocationCallbacks* allocator)
+            : Surface(Created(), instance, window, allocator, createSurface(instance, window, allocator))
+    {
+        if(surface == VK_NULL_HANDLE)
+        {
+            throw std::runtime_error(getError());
+        }
+    }
+
+    Surface::~Surface()
+    {
+        reset();
+    }
+
+    Surface::Surface(Surface&& other) noexcept : instance(other.instance),
+            surface(std::exchange(other.surface, VK_NULL_HANDLE)), allocator(other.allocator), destroy(other.destroy),
+            window(std::move(other.window))
+    {
+    }
+
+    Surface& Surface::operator=(Surface&& other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            instance = other.instance;
+            surface = std::exchange(other.surface, VK_NULL_HANDLE);
+            allocator = other.allocator;
+            destroy = other.destroy;
+            window = std::move(other.window);
+        }
+        return *this;
+    }
+
+    Result<Surface> Surface::tryCreate(VkInstance instance, const Window& window, const VkAllocationCallbacks* allocator)
+    {
+        auto surface = createSurface(instance, window, allocator);
+        if(surface == VK_NULL_HANDLE)
+        {
+            return getLastError();
+        }
+        return Surface(Created(), instance, window, allocator, surface);
+    }
+
+    void Surface::reset()
+    {
+        if(surface != VK_NULL_HANDLE)
+        {
+            // Looked up at creation, GLFW would have failed to create the surface without the function existing
+            destroy(instance, surface, allocator);
+            surface = VK_NULL_HANDLE;
+        }
+        window.reset();
+    }
+
+    VkSurfaceKHR Surface::get() const
+    {
+        return surface;
+    }
+
+    VkInstance Surface::getInstance() const
+    {
+        return instance;
+    }
+
+    Surface::operator VkSurfaceKHR() const
+    {
+        return surface;
+    }
+
+    Surface::operator bool() const
+    {
+        return surface != VK_NULL_HANDLE;
+    }
+}
@@ -20,22 +20,64 @@
 
 module;
 
+#include <algorithm>
 #include <memory>
 #include <cassert>
 #include <functional>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <vector>
 #include <GLFW/glfw3.h>
 
-//#include "checks.h";
-
 module glfw;
 
 namespace glfw
 {
+    namespace
+    {
+        // Windows with a coalesce mode set, flushed after every poll
+        std::vector<GLFWwindow*> coalescingWindows;
+
+        void flushCoalescingWindows(void*)
+        {
+            // Indexed as a callback may change the coalesce mode of a window while it is being flushed
+            for(std::size_t i = 0; i < coalescingWindows.size(); ++i)
+            {
+                if(auto callbacks = static_cast<WindowCallbacks*>(glfwGetWindowUserPointer(coalescingWindows[i])))
+                {
+                    callbacks->window.flushCoalescedInput();
+                }
+            }
+        }
+
+        void setCoalescing(GLFWwindow* ptr, bool coalescing)
+        {
+            std::erase(coalescingWindows, ptr);
+            if(coalescing)
+            {
+                if(coalescingWindows.empty())
+                {
+                    addEventHook(flushCoalescingWindows, nullptr);
+                }
+                coalescingWindows.push_back(ptr);
+            }
+            else if(coalescingWindows.empty())
+            {
+                removeEventHook(flushCoalescingWindows, nullptr);
+            }
+        }
+    }
+
     void Deleter::operator()(GLFWwindow* ptr)
     {
         if(ptr)
         {
+            if(std::ranges::find(coalescingWindows, ptr) != coalescingWindows.end())
+            {
+                setCoalescing(ptr, false);
+            }
+            releaseProcCache(ptr);
             glfwDestroyWindow(ptr);
         }
     }
@@ -43,47 +85,53 @@ namespace glfw
     void defaultWindowHints()
     {
         glfwDefaultWindowHints();
+        resetTrackedWindowHints();
+        applyLibraryWindowHints();
     }
 
     void windowHint(WindowHint hint, bool value)
     {
-        //assert(validateHintBoolean(hint) && "Hint is not valid or does not take a boolean");
+        assert(validateHintBoolean(hint) && "Hint is not valid or does not take a boolean");
         windowHint(hint, value ? GLFW_TRUE : GLFW_FALSE);
     }
 
     void windowHint(WindowHint hint, WindowValue value)
     {
-        //assert(validateHintEnum(hint) && "Hint is not valid or does not take an enum value");
+        assert(validateHintEnum(hint) && "Hint is not valid or does not take an enum value");
         windowHint(hint, static_cast<int>(value));
     }
 
     void windowHint(WindowHint hint, int value)
     {
-        //assert(validateHintValue(hint, value) && "Hint is not valid or provided value is invalid");
+        assert(validateHintValue(hint, value) && "Hint is not valid or provided value is invalid");
         windowHint(static_cast<int>(hint), value);
     }
 
     void windowHint(WindowHint hint, const char* value)
     {
-        //assert(validateHintString(hint) && "Hint is not valid or does not take a string value");
+        assert(validateHintString(hint) && "Hint is not valid or does not take a string value");
         windowHint(static_cast<int>(hint), value);
     }
 
     void windowHint(int hint, const char* value)
     {
+        invalidateAppliedHints();
         glfwWindowHintString(hint, value);
     }
 
     void windowHint(int hint, int value)
     {
         // No programmer checks here, not recommended for use
+        invalidateAppliedHints();
+        trackWindowHint(hint, value);
         glfwWindowHint(hint, value);
     }
 
     Window* getCurrentContext()
     {
         auto window = glfwGetCurrentContext();
-        return static_cast<Window *>(glfwGetWindowUserPointer(window));
+        auto callbacks = window ? static_cast<WindowCallbacks*>(glfwGetWindowUserPointer(window)) : nullptr;
+        return callbacks ? &callbacks->window : nullptr;
     }
 
     // Window methods below
@@ -93,7 +141,7 @@ namespace glfw
     GLFWwindow* createWindow(int width, int height, const char *title, Monitor* monitor, Window* share)
     {
         GLFWmonitor* mon = monitor == nullptr ? nullptr: *monitor;
-        GLFWwindow* win = share == nullptr ? nullptr: *share;
+        GLFWwindow* win = share == nullptr ? nullptr: share->get();
 
         auto windowPtr = glfwCreateWindow(width, height, title, mon, win);
         if(!windowPtr)
@@ -105,14 +153,181 @@ namespace glfw
 
     Window::Window(int width, int height, const char* title, Monitor* monitor, Window* share) : Window(createWindow(width, height, title, monitor, share)) {}
 
+    Result<Window> Window::tryCreate(int width, int height, const char* title, Monitor* monitor, Window* share)
+    {
+        GLFWmonitor* mon = monitor == nullptr ? nullptr: *monitor;
+        GLFWwindow* win = share == nullptr ? nullptr: share->get();
+
+        auto windowPtr = glfwCreateWindow(width, height, title, mon, win);
+        if(!windowPtr)
+        {
+            return getLastError();
+        }
+        return Window(windowPtr);
+    }
+
     Window::Window(GLFWwindow* window) : ptr(window, Deleter()), callbacks(std::make_shared<WindowCallbacks>())
     {
-        if(ptr.get())
+        if(!window)
         {
-            glfwSetWindowUserPointer(ptr.get(), this);
+            return;
+        }
+
+        // Copies never touch the user pointer, so they may be made and dropped on any thread
+        callbacks->window.ptr = ptr;
+        callbacks->window.callbacks = std::shared_ptr<WindowCallbacks>(std::shared_ptr<WindowCallbacks>(), callbacks.get());
+        glfwSetWindowUserPointer(window, callbacks.get());
+
+        // The state updated by the dispatchers is seeded here and every dispatcher observe feeds is installed, so
+        //  queued mode, coalescing, recording, latency tracking and the awaiters never have to install them later and
+        //  risk replacing a bound handler
+        callbacks->focused = glfwGetWindowAttrib(window, GLFW_FOCUSED);
+        callbacks->iconified = glfwGetWindowAttrib(window, GLFW_ICONIFIED);
+        setPosCallback();
+        setSizeCallback();
+        setFocusCallback();
+        setIconifyCallback();
+        setFramebufferSizeCallback();
+        setContentScaleCallback();
+        setKeyCallback(nullptr);
+        setCharCallback(nullptr);
+        setMouseButtonCallback(nullptr);
+        setCursorPosCallback(nullptr);
+        setScrollCallback(nullptr);
+        setDropCallback(nullptr);
+    }
+
+    void Window::updateProperties(Window& window, const Event& event)
+    {
+        auto& state = *window.callbacks;
+        switch(event.type)
+        {
+            case EventType::FOCUS:
+                state.focused = event.focused;
+                break;
+
+            case EventType::ICONIFY:
+                state.iconified = event.iconified;
+                break;
+
+            case EventType::WINDOW_POS:
+                if(auto properties = state.properties.get())
+                {
+                    properties->pos = event.pos;
+                }
+                break;
+
+            case EventType::WINDOW_SIZE:
+                if(auto properties = state.properties.get())
+                {
+                    properties->size = event.size;
+                }
+                break;
+
+            case EventType::FRAMEBUFFER_SIZE:
+                if(auto properties = state.properties.get())
+                {
+                    properties->framebufferSize = event.size;
+                }
+                if(auto renderThread = state.renderThread)
+                {
+                    renderThread->resize(event.size);
+                }
+                break;
+
+            case EventType::CONTENT_SCALE:
+                if(auto properties = state.properties.get())
+                {
+                    properties->contentScale = event.contentScale;
+                }
+                break;
+
+            default:
+                break;
         }
     }
 
+    void Window::observe(Window& window, const Event& event)
+    {
+        auto& state = *window.callbacks;
+        switch(event.type)
+        {
+            case EventType::KEY:
+            case EventType::CHAR:
+            case EventType::MOUSE_BUTTON:
+                if(auto tracker = state.latencyTracker)
+                {
+                    tracker->tag(event.type);
+                }
+                // Pending motion goes out first so it stays ordered with this event
+                window.flushCoalescedInput();
+                break;
+
+            case EventType::CURSOR_POS:
+            case EventType::SCROLL:
+                if(auto tracker = state.latencyTracker)
+                {
+                    tracker->tag(event.type);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        updateProperties(window, event);
+        if(auto recorder = state.recorder)
+        {
+            recorder->record(window.ptr.get(), event);
+        }
+
+        switch(event.type)
+        {
+            case EventType::KEY:
+                if(!state.keyAwaiters.empty())
+                {
+                    state.keyAwaiters.complete(event.key);
+                }
+                break;
+
+            case EventType::MOUSE_BUTTON:
+                if(!state.mouseButtonAwaiters.empty())
+                {
+                    state.mouseButtonAwaiters.complete(event.mouseButton);
+                }
+                break;
+
+            case EventType::FRAMEBUFFER_SIZE:
+                if(!state.framebufferSizeAwaiters.empty())
+                {
+                    state.framebufferSizeAwaiters.complete(event.size);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void Window::observeDrop(Window& window, int count, const char* paths[])
+    {
+        if(auto recorder = window.callbacks->recorder)
+        {
+            recorder->recordDrop(window.ptr.get(), count, paths);
+        }
+    }
+
+    Window::Window(const Window& other) : ptr(other.ptr), callbacks(other.callbacks ? other.callbacks->shared_from_this() : nullptr) {}
+
+    Window& Window::operator=(const Window& other)
+    {
+        ptr = other.ptr;
+        callbacks = other.callbacks ? other.callbacks->shared_from_this() : nullptr;
+        return *this;
+    }
+
+    Window::~Window() = default;
+
     GLFWwindow* Window::get() const
     {
         assert(ptr.get() != nullptr);
@@ -153,15 +368,31 @@ namespace glfw
         glfwSetWindowTitle(ptr.get(), title);
     }
 
-    void Window::setIcon(const std::vector<Image>& images) // TODO: implement once Image is implemented, does it need to be optional?
+    void Window::setIcon(std::span<const Image> images)
+    {
+        std::vector<ImageView> views(images.begin(), images.end());
+        setIcon(views);
+    }
+
+    void Window::setIcon(std::span<const ImageView> images)
     {
         assert(ptr.get() != nullptr);
-        glfwSetWindowIcon(ptr.get(), images.size(), images.data());
+        glfwSetWindowIcon(ptr.get(), static_cast<int>(images.size()), images.data());
+    }
+
+    void Window::resetIcon()
+    {
+        assert(ptr.get() != nullptr);
+        glfwSetWindowIcon(ptr.get(), 0, nullptr);
     }
 
     Position<int> Window::getPos() const
     {
         assert(ptr.get() != nullptr);
+        if(auto properties = callbacks->properties.get())
+        {
+            return properties->pos;
+        }
         int x, y;
         glfwGetWindowPos(ptr.get(), &x, &y);
         return {x, y};
@@ -176,6 +407,10 @@ namespace glfw
     Size Window::getSize() const
     {
         assert(ptr.get() != nullptr);
+        if(auto properties = callbacks->properties.get())
+        {
+            return properties->size;
+        }
         int width, height;
         glfwGetWindowSize(ptr.get(), &width, &height);
         return {width, height};
@@ -202,6 +437,10 @@ namespace glfw
     Size Window::getFramebufferSize() const
     {
         assert(ptr.get() != nullptr);
+        if(auto properties = callbacks->properties.get())
+        {
+            return properties->framebufferSize;
+        }
         int width, height;
         glfwGetFramebufferSize(ptr.get(), &width, &height);
         return {width, height};
@@ -210,6 +449,10 @@ namespace glfw
     FrameSize Window::getFrameSize()
     {
         assert(ptr.get() != nullptr);
+        if(auto properties = callbacks->properties.get())
+        {
+            return properties->frameSize;
+        }
         int left, right, top, bottom;
         glfwGetWindowFrameSize(ptr.get(), &left, &top, &right, &bottom);
         return {left, top, right, bottom};
@@ -218,6 +461,10 @@ namespace glfw
     Scale Window::getContentScale()
     {
         assert(ptr.get() != nullptr);
+        if(auto properties = callbacks->properties.get())
+        {
+            return properties->contentScale;
+        }
         float width, height;
         glfwGetWindowContentScale(ptr.get(), &width, &height);
         return {width, height};
@@ -226,6 +473,10 @@ namespace glfw
     float Window::getOpacity() const
     {
         assert(ptr.get() != nullptr);
+        if(auto properties = callbacks->properties.get())
+        {
+            return properties->opacity;
+        }
         return glfwGetWindowOpacity(ptr.get());
     }
 
@@ -233,6 +484,11 @@ namespace glfw
     {
         assert(ptr.get() != nullptr);
         glfwSetWindowOpacity(ptr.get(), opacity);
+        if(auto properties = callbacks->properties.get())
+        {
+            // Read back as the platform may not support the value asked for
+            properties->opacity = glfwGetWindowOpacity(ptr.get());
+        }
     }
 
     void Window::iconify()
@@ -287,6 +543,11 @@ namespace glfw
     {
         assert(ptr.get() != nullptr);
         glfwSetWindowMonitor(ptr.get(), monitor, pos.x, pos.y, size.width, size.height, refreshRate);
+        if(auto properties = callbacks->properties.get())
+        {
+            auto& frame = properties->frameSize;
+            glfwGetWindowFrameSize(ptr.get(), &frame.left, &frame.top, &frame.right, &frame.bottom);
+        }
     }
 
     int Window::getAttrib(int attrib) const // TODO: enum values?
@@ -299,18 +560,23 @@ namespace glfw
     {
         assert(ptr.get() != nullptr);
         glfwSetWindowAttrib(ptr.get(), attrib, value);
+        if(auto properties = callbacks->properties.get(); properties && attrib == GLFW_DECORATED)
+        {
+            auto& frame = properties->frameSize;
+            glfwGetWindowFrameSize(ptr.get(), &frame.left, &frame.top, &frame.right, &frame.bottom);
+        }
     }
 
     void Window::setUserPointer(void* pointer)
     {
         assert(ptr.get() != nullptr);
-        user = pointer;
+        callbacks->user = pointer;
     }
 
     void* Window::getUserPointer() const
     {
         assert(ptr.get() != nullptr);
-        return user;
+        return callbacks->user;
     }
 
     WindowPosFunction Window::setPosCallback(WindowPosFunction callback)
@@ -319,8 +585,18 @@ namespace glfw
         callbacks->windowPosFunction = callback;
         glfwSetWindowPosCallback(ptr.get(), [](GLFWwindow* ptr, int x, int y)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowPosFunction(*window, {x, y});
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::WINDOW_POS};
+            event.pos = {x, y};
+            observe(*window, event);
+            if(window->callbacks->windowPosFunction)
+            {
+                window->callbacks->windowPosFunction(*window, event.pos);
+            }
         });
         return callback;
     }
@@ -331,8 +607,23 @@ namespace glfw
         callbacks->windowSizeFunction = callback;
         glfwSetWindowSizeCallback(ptr.get(), [](GLFWwindow* ptr, int w, int h)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowSizeFunction(*window, {w, h});
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::WINDOW_SIZE};
+            event.size = {w, h};
+            observe(*window, event);
+            if(auto queue = window->callbacks->eventQueue.get())
+            {
+                queue->push(event);
+            }
+            else if(window->callbacks->windowSizeFunction)
+            {
+                ScopedTimer timer(Metric::DISPATCH_WINDOW_SIZE);
+                window->callbacks->windowSizeFunction(*window, {w, h});
+            }
         });
         return callback;
     }
@@ -343,8 +634,11 @@ namespace glfw
         callbacks->windowCloseFunction = callback;
         glfwSetWindowCloseCallback(ptr.get(), [](GLFWwindow* ptr)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowCloseFunction(*window);
+            auto window = fromHandle(ptr);
+            if(window && window->callbacks->windowCloseFunction)
+            {
+                window->callbacks->windowCloseFunction(*window);
+            }
         });
         return callback;
     }
@@ -355,8 +649,11 @@ namespace glfw
         callbacks->windowRefreshFunction = callback;
         glfwSetWindowRefreshCallback(ptr.get(), [](GLFWwindow* ptr)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowRefreshFunction(*window);
+            auto window = fromHandle(ptr);
+            if(window && window->callbacks->windowRefreshFunction)
+            {
+                window->callbacks->windowRefreshFunction(*window);
+            }
         });
         return callback;
     }
@@ -367,8 +664,23 @@ namespace glfw
         callbacks->windowFocusFunction = callback;
         glfwSetWindowFocusCallback(ptr.get(), [](GLFWwindow* ptr, int f)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowFocusFunction(*window, f == GLFW_TRUE);
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::FOCUS};
+            event.focused = f == GLFW_TRUE;
+            observe(*window, event);
+            if(auto queue = window->callbacks->eventQueue.get())
+            {
+                queue->push(event);
+            }
+            else if(window->callbacks->windowFocusFunction)
+            {
+                ScopedTimer timer(Metric::DISPATCH_FOCUS);
+                window->callbacks->windowFocusFunction(*window, f == GLFW_TRUE);
+            }
         });
         return callback;
     }
@@ -379,8 +691,18 @@ namespace glfw
         callbacks->windowIconifyFunction = callback;
         glfwSetWindowIconifyCallback(ptr.get(), [](GLFWwindow* ptr, int i)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowIconifyFunction(*window, i == GLFW_TRUE);
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::ICONIFY};
+            event.iconified = i == GLFW_TRUE;
+            observe(*window, event);
+            if(window->callbacks->windowIconifyFunction)
+            {
+                window->callbacks->windowIconifyFunction(*window, event.iconified);
+            }
         });
         return callback;
     }
@@ -391,8 +713,11 @@ namespace glfw
         callbacks->windowMaximizeFunction = callback;
         glfwSetWindowMaximizeCallback(ptr.get(), [](GLFWwindow* ptr, int m)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowMaximizeFunction(*window, m == GLFW_TRUE);
+            auto window = fromHandle(ptr);
+            if(window && window->callbacks->windowMaximizeFunction)
+            {
+                window->callbacks->windowMaximizeFunction(*window, m == GLFW_TRUE);
+            }
         });
         return callback;
     }
@@ -403,8 +728,23 @@ namespace glfw
         callbacks->windowFrameBufferSizeFunction = callback;
         glfwSetFramebufferSizeCallback(ptr.get(), [](GLFWwindow* ptr, int w, int h)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowFrameBufferSizeFunction(*window, {w, h});
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::FRAMEBUFFER_SIZE};
+            event.size = {w, h};
+            observe(*window, event);
+            if(auto queue = window->callbacks->eventQueue.get())
+            {
+                queue->push(event);
+            }
+            else if(window->callbacks->windowFrameBufferSizeFunction)
+            {
+                ScopedTimer timer(Metric::DISPATCH_FRAMEBUFFER_SIZE);
+                window->callbacks->windowFrameBufferSizeFunction(*window, {w, h});
+            }
         });
         return callback;
     }
@@ -415,8 +755,18 @@ namespace glfw
         callbacks->windowContentScaleFunction = callback;
         glfwSetWindowContentScaleCallback(ptr.get(), [](GLFWwindow* ptr, float x, float y)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->windowContentScaleFunction(*window, {x, y});
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::CONTENT_SCALE};
+            event.contentScale = {x, y};
+            observe(*window, event);
+            if(window->callbacks->windowContentScaleFunction)
+            {
+                window->callbacks->windowContentScaleFunction(*window, event.contentScale);
+            }
         });
         return callback;
     }
@@ -479,7 +829,13 @@ namespace glfw
     void Window::setCursor(Cursor* cursor)
     {
         assert(ptr.get() != nullptr);
-        glfwSetCursor(ptr.get(), *cursor);
+        glfwSetCursor(ptr.get(), cursor == nullptr ? nullptr : static_cast<GLFWcursor*>(*cursor));
+    }
+
+    void Window::setCursor(CursorHandle cursor)
+    {
+        assert(ptr.get() != nullptr);
+        glfwSetCursor(ptr.get(), cursor);
     }
 
     KeyFunction Window::setKeyCallback(KeyFunction callback)
@@ -488,8 +844,23 @@ namespace glfw
         callbacks->keyFunction = callback;
         glfwSetKeyCallback(ptr.get(), [](GLFWwindow* ptr, int key, int scancode, int action, int mods)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->keyFunction(*window, static_cast<Key>(key), scancode, static_cast<KeyAction>(action), mods);
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::KEY};
+            event.key = {static_cast<Key>(key), scancode, static_cast<KeyAction>(action), mods};
+            observe(*window, event);
+            if(auto queue = window->callbacks->eventQueue.get())
+            {
+                queue->push(event);
+            }
+            else if(window->callbacks->keyFunction)
+            {
+                ScopedTimer timer(Metric::DISPATCH_KEY);
+                window->callbacks->keyFunction(*window, static_cast<Key>(key), scancode, static_cast<KeyAction>(action), mods);
+            }
         });
         return callback;
     }
@@ -500,8 +871,23 @@ namespace glfw
         callbacks->charFunction = callback;
         glfwSetCharCallback(ptr.get(), [](GLFWwindow* ptr, unsigned int codepoint)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->charFunction(*window, codepoint);
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::CHAR};
+            event.codepoint = codepoint;
+            observe(*window, event);
+            if(auto queue = window->callbacks->eventQueue.get())
+            {
+                queue->push(event);
+            }
+            else if(window->callbacks->charFunction)
+            {
+                ScopedTimer timer(Metric::DISPATCH_CHAR);
+                window->callbacks->charFunction(*window, codepoint);
+            }
         });
         return callback;
     }
@@ -512,8 +898,11 @@ namespace glfw
         callbacks->charModsFunction = callback;
         glfwSetCharModsCallback(ptr.get(), [](GLFWwindow* ptr, unsigned int codepoint, int mods)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->charModsFunction(*window, codepoint, mods);
+            auto window = fromHandle(ptr);
+            if(window && window->callbacks->charModsFunction)
+            {
+                window->callbacks->charModsFunction(*window, codepoint, mods);
+            }
         });
         return callback;
     }
@@ -524,9 +913,21 @@ namespace glfw
         callbacks->mouseButtonFunction = callback;
         glfwSetMouseButtonCallback(ptr.get(), [](GLFWwindow* ptr, int button, int action, int mods)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            if(window && window->callbacks->mouseButtonFunction)
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::MOUSE_BUTTON};
+            event.mouseButton = {static_cast<MouseButton>(button), static_cast<KeyAction>(action), mods};
+            observe(*window, event);
+            if(auto queue = window->callbacks->eventQueue.get())
+            {
+                queue->push(event);
+            }
+            else if(window->callbacks->mouseButtonFunction)
             {
+                ScopedTimer timer(Metric::DISPATCH_MOUSE_BUTTON);
                 window->callbacks->mouseButtonFunction(*window, static_cast<MouseButton>(button), static_cast<KeyAction>(action), mods);
             }
         });
@@ -539,10 +940,17 @@ namespace glfw
         callbacks->cursorPosFunction = callback;
         glfwSetCursorPosCallback(ptr.get(), [](GLFWwindow* ptr, double xpos, double ypos)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            if(window && window->callbacks->cursorPosFunction)
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::CURSOR_POS};
+            event.cursorPos = {xpos, ypos};
+            observe(*window, event);
+            if(!window->coalesceCursorPos(event.cursorPos))
             {
-                window->callbacks->cursorPosFunction(*window, {xpos, ypos});
+                window->dispatchCursorPos(event.cursorPos);
             }
         });
         return callback;
@@ -554,8 +962,11 @@ namespace glfw
         callbacks->cursorEnterFunction = callback;
         glfwSetCursorEnterCallback(ptr.get(), [](GLFWwindow* ptr, int e)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->cursorEnterFunction(*window, e == GLFW_TRUE);
+            auto window = fromHandle(ptr);
+            if(window && window->callbacks->cursorEnterFunction)
+            {
+                window->callbacks->cursorEnterFunction(*window, e == GLFW_TRUE);
+            }
         });
         return callback;
     }
@@ -566,8 +977,18 @@ namespace glfw
         callbacks->scrollFunction = callback;
         glfwSetScrollCallback(ptr.get(), [](GLFWwindow* ptr, double xoffset, double yoffset)
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->scrollFunction(*window, {xoffset, yoffset});
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            Event event{EventType::SCROLL};
+            event.scroll = {xoffset, yoffset};
+            observe(*window, event);
+            if(!window->coalesceScroll(event.scroll))
+            {
+                window->dispatchScroll(event.scroll);
+            }
         });
         return callback;
     }
@@ -578,12 +999,269 @@ namespace glfw
         callbacks->dropFunction = callback;
         glfwSetDropCallback(ptr.get(), [](GLFWwindow* ptr, int path_count, const char* paths[])
         {
-            auto window = static_cast<Window*>(glfwGetWindowUserPointer(ptr));
-            window->callbacks->dropFunction(*window, path_count, paths);
+            auto window = fromHandle(ptr);
+            if(!window)
+            {
+                return;
+            }
+            observeDrop(*window, path_count, paths);
+            if(window->callbacks->dropFunction)
+            {
+                window->callbacks->dropFunction(*window, path_count, paths);
+            }
         });
         return callback;
     }
 
+    void Window::enableEventQueue(std::size_t capacity)
+    {
+        assert(ptr.get() != nullptr);
+        callbacks->eventQueue = std::make_unique<EventQueue>(capacity);
+    }
+
+    void Window::disableEventQueue()
+    {
+        assert(ptr.get() != nullptr);
+        callbacks->eventQueue.reset();
+    }
+
+    bool Window::isEventQueueEnabled() const
+    {
+        assert(ptr.get() != nullptr);
+        return callbacks->eventQueue != nullptr;
+    }
+
+    void Window::enablePropertyCache()
+    {
+        assert(ptr.get() != nullptr);
+        callbacks->properties = std::make_unique<WindowProperties>();
+        refresh();
+    }
+
+    void Window::disablePropertyCache()
+    {
+        assert(ptr.get() != nullptr);
+        callbacks->properties.reset();
+    }
+
+    bool Window::isPropertyCacheEnabled() const
+    {
+        assert(ptr.get() != nullptr);
+        return callbacks->properties != nullptr;
+    }
+
+    void Window::refresh()
+    {
+        assert(ptr.get() != nullptr);
+        auto properties = callbacks->properties.get();
+        if(!properties)
+        {
+            return;
+        }
+
+        auto window = ptr.get();
+        glfwGetWindowPos(window, &properties->pos.x, &properties->pos.y);
+        glfwGetWindowSize(window, &properties->size.width, &properties->size.height);
+        glfwGetFramebufferSize(window, &properties->framebufferSize.width, &properties->framebufferSize.height);
+        glfwGetWindowContentScale(window, &properties->contentScale.x, &properties->contentScale.y);
+        auto& frame = properties->frameSize;
+        glfwGetWindowFrameSize(window, &frame.left, &frame.top, &frame.right, &frame.bottom);
+        properties->opacity = glfwGetWindowOpacity(window);
+    }
+
+    std::span<const Event> Window::drainEvents()
+    {
+        assert(ptr.get() != nullptr);
+        if(!callbacks->eventQueue)
+        {
+            return {};
+        }
+        return callbacks->eventQueue->drain();
+    }
+
+    uint64_t Window::getDroppedEventCount() const
+    {
+        assert(ptr.get() != nullptr);
+        return callbacks->eventQueue ? callbacks->eventQueue->getDroppedCount() : 0;
+    }
+
+    void Window::unbind()
+    {
+        assert(ptr.get() != nullptr);
+        callbacks->boundHandler = nullptr;
+
+        // Put the callback function dispatchers back for every event a handler could have been bound to
+        setPosCallback(callbacks->windowPosFunction);
+        setSizeCallback(callbacks->windowSizeFunction);
+        setCloseCallback(callbacks->windowCloseFunction);
+        setRefreshCallback(callbacks->windowRefreshFunction);
+        setFocusCallback(callbacks->windowFocusFunction);
+        setIconifyCallback(callbacks->windowIconifyFunction);
+        setMaximizeCallback(callbacks->windowMaximizeFunction);
+        setFramebufferSizeCallback(callbacks->windowFrameBufferSizeFunction);
+        setContentScaleCallback(callbacks->windowContentScaleFunction);
+        setKeyCallback(callbacks->keyFunction);
+        setCharCallback(callbacks->charFunction);
+        setCharModsCallback(callbacks->charModsFunction);
+        setMouseButtonCallback(callbacks->mouseButtonFunction);
+        setCursorPosCallback(callbacks->cursorPosFunction);
+        setCursorEnterCallback(callbacks->cursorEnterFunction);
+        setScrollCallback(callbacks->scrollFunction);
+        setDropCallback(callbacks->dropFunction);
+    }
+
+    void Window::setCoalesceMode(CoalesceMode mode)
+    {
+        assert(ptr.get() != nullptr);
+        flushCoalescedInput();
+
+        callbacks->coalesceMode = mode;
+        callbacks->lastCursorPos = getCursorPos();
+        setCoalescing(ptr.get(), mode != CoalesceMode::NONE);
+    }
+
+    CoalesceMode Window::getCoalesceMode() const
+    {
+        assert(ptr.get() != nullptr);
+        return callbacks->coalesceMode;
+    }
+
+    const CoalescedInput& Window::getCoalescedInput() const
+    {
+        assert(ptr.get() != nullptr);
+        return callbacks->coalesced;
+    }
+
+    CoalesceStats Window::getCoalesceStats() const
+    {
+        assert(ptr.get() != nullptr);
+        return callbacks->coalesceStats;
+    }
+
+    void Window::flushCoalescedInput()
+    {
+        assert(ptr.get() != nullptr);
+        auto& pending = callbacks->coalescePending;
+        if(pending.cursorEvents == 0 && pending.scrollEvents == 0)
+        {
+            return;
+        }
+
+        // Reset before dispatching so a callback that triggers more input starts a fresh aggregate
+        callbacks->coalesced = pending;
+        pending = {};
+
+        const auto& flushed = callbacks->coalesced;
+        if(flushed.cursorEvents > 0)
+        {
+            dispatchCursorPos(flushed.cursorPos);
+        }
+        if(flushed.scrollEvents > 0)
+        {
+            dispatchScroll(flushed.scroll);
+        }
+    }
+
+    bool Window::coalesceCursorPos(Position<double> pos)
+    {
+        if(callbacks->coalesceMode == CoalesceMode::NONE)
+        {
+            return false;
+        }
+
+        auto& pending = callbacks->coalescePending;
+        auto& stats = callbacks->coalesceStats;
+        stats.cursorEvents++;
+        if(pending.cursorEvents++ > 0)
+        {
+            stats.cursorFolded++;
+        }
+
+        pending.cursorDelta.x += pos.x - callbacks->lastCursorPos.x;
+        pending.cursorDelta.y += pos.y - callbacks->lastCursorPos.y;
+        pending.cursorPos = pos;
+        callbacks->lastCursorPos = pos;
+        return true;
+    }
+
+    bool Window::coalesceScroll(Position<double> offset)
+    {
+        if(callbacks->coalesceMode == CoalesceMode::NONE)
+        {
+            return false;
+        }
+
+        auto& pending = callbacks->coalescePending;
+        auto& stats = callbacks->coalesceStats;
+        stats.scrollEvents++;
+        if(pending.scrollEvents++ > 0)
+        {
+            stats.scrollFolded++;
+        }
+
+        if(callbacks->coalesceMode == CoalesceMode::ACCUMULATE_DELTA)
+        {
+            pending.scroll.x += offset.x;
+            pending.scroll.y += offset.y;
+        }
+        else
+        {
+            pending.scroll = offset;
+        }
+        return true;
+    }
+
+    void Window::dispatchCursorPos(Position<double> pos)
+    {
+        if(auto queue = callbacks->eventQueue.get())
+        {
+            Event event{EventType::CURSOR_POS};
+            event.cursorPos = pos;
+            queue->push(event);
+        }
+        else if(callbacks->cursorPosFunction)
+        {
+            ScopedTimer timer(Metric::DISPATCH_CURSOR_POS);
+            callbacks->cursorPosFunction(*this, pos);
+        }
+    }
+
+    void Window::dispatchScroll(Position<double> offset)
+    {
+        if(auto queue = callbacks->eventQueue.get())
+        {
+            Event event{EventType::SCROLL};
+            event.scroll = offset;
+            queue->push(event);
+        }
+        else if(callbacks->scrollFunction)
+        {
+            ScopedTimer timer(Metric::DISPATCH_SCROLL);
+            callbacks->scrollFunction(*this, offset);
+        }
+    }
+
+    EventAwaiter<KeyEvent> Window::nextKey()
+    {
+        assert(ptr.get() != nullptr);
+        installCoroutineScheduler();
+        return EventAwaiter<KeyEvent>(callbacks->keyAwaiters);
+    }
+
+    EventAwaiter<MouseButtonEvent> Window::nextMouseButton()
+    {
+        assert(ptr.get() != nullptr);
+        installCoroutineScheduler();
+        return EventAwaiter<MouseButtonEvent>(callbacks->mouseButtonAwaiters);
+    }
+
+    EventAwaiter<Size> Window::framebufferResized()
+    {
+        assert(ptr.get() != nullptr);
+        installCoroutineScheduler();
+        return EventAwaiter<Size>(callbacks->framebufferSizeAwaiters);
+    }
+
     void Window::setClipboardString(const char* string)
     {
         assert(ptr.get() != nullptr);
@@ -605,6 +1283,22 @@ namespace glfw
     void Window::swapBuffers()
     {
         assert(ptr.get() != nullptr);
-        glfwSwapBuffers(ptr.get());
+        {
+            ScopedTimer timer(Metric::SWAP_BUFFERS);
+            glfwSwapBuffers(ptr.get());
+        }
+        if(auto tracker = callbacks->latencyTracker)
+        {
+            tracker->present();
+        }
+
+#ifdef GLFW_CPP_INSTRUMENTATION
+        // Per window as each one keeps its own frame rate, atomic as a render thread may swap
+        auto now = glfwGetTimerValue();
+        if(auto lastSwap = callbacks->lastSwap.exchange(now, std::memory_order_relaxed); lastSwap != 0)
+        {
+            recordTicks(Metric::FRAME_INTERVAL, now - lastSwap);
+        }
+#endif
     }
 }